@@ -5,6 +5,7 @@
 void Bullet::pop() {
 	state = Bullet::POPPED_REQUESTED;
 	RS::get_singleton()->canvas_item_set_visible(ci_rid, false);
+	render_shown = false;
 }
 
 bool Bullet::is_popped() {
@@ -19,18 +20,27 @@ bool Bullet::can_collide() {
 	return !is_popped() && texture.is_valid() && !texture->get_collision_shape().is_null() && texture->get_collision_mask() != 0;
 }
 
+uint64_t Bullet::_get_clock_usec() const {
+	//bullets owned by a server follow its simulation clock, free-standing bullets fall back to wall-clock time
+	if (clock) {
+		return *clock;
+	}
+	return Time::get_singleton()->get_ticks_usec();
+}
+
 float Bullet::get_age() const {
-	return (Time::get_singleton()->get_ticks_msec() - spawntime)/1000.0;
+	return (_get_clock_usec() - spawntime)/1000000.0;
 }
 
 float Bullet::get_path_time() const {
-	return (Time::get_singleton()->get_ticks_msec() - path_start)/1000.0;
+	return (_get_clock_usec() - path_start)/1000000.0;
 }
 
 void Bullet::set_texture(const Ref<BulletTexture> &p_texture) {
 	ERR_FAIL_COND_MSG(!p_texture.is_valid(), "Passed BulletTexture is invalid. Cannot update.");
 
 	texture = p_texture;
+	type_revision = 0;
 
 	RenderingServer *rs = RS::get_singleton();
 	Ref<Texture2D> sprite = p_texture->get_texture();
@@ -39,11 +49,12 @@ void Bullet::set_texture(const Ref<BulletTexture> &p_texture) {
 
 	ERR_FAIL_COND_MSG(!sprite.is_valid(), "Passed BulletTexture has no Texture2D. Cannot render.");
 
-	sprite->draw(ci_rid, -sprite->get_size()/2);
+	//canvas items can't animate without being redrawn, so sprite sheets show their start frame
+	Rect2 frame = p_texture->get_frame_rect(p_texture->get_animation_start_frame());
+	sprite->draw_rect_region(ci_rid, Rect2(-frame.size/2, frame.size), frame);
 
-	if (p_texture->get_material().is_valid()) {
-		rs->canvas_item_set_material(ci_rid, p_texture->get_material()->get_rid());
-	}
+	//a redraw can drop a material the canvas item was given before
+	rs->canvas_item_set_material(ci_rid, p_texture->get_material().is_valid() ? p_texture->get_material()->get_rid() : RID());
 	
 	rs->canvas_item_set_modulate(ci_rid, p_texture->get_modulate());
 	rs->canvas_item_set_light_mask(ci_rid, p_texture->get_light_mask());
@@ -56,7 +67,7 @@ Ref<BulletTexture> Bullet::get_texture() const {
 void Bullet::set_path(const Ref<BulletPath> &p_path) {
 	ERR_FAIL_COND_MSG(!p_path.is_valid(), "Passed BulletPath is invalid. Cannot update.");
 	path = p_path;
-	path_start = Time::get_singleton()->get_ticks_msec();
+	path_start = _get_clock_usec();
 }
 
 Ref<BulletPath> Bullet::get_path() const {
@@ -65,30 +76,69 @@ Ref<BulletPath> Bullet::get_path() const {
 
 void Bullet::set_position(const Vector2 &p_position) {
 	transform.set_origin(p_position);
+	render_dirty = true;
 }
 
 Vector2 Bullet::get_position() const {
 	return transform.get_origin();
 }
 
+void Bullet::apply_impulse(const Vector2 &p_impulse) {
+	impulse_velocity += p_impulse;
+}
+
+void Bullet::apply_force(const Vector2 &p_force) {
+	impulse_force += p_force;
+}
+
+void Bullet::clear_forces() {
+	impulse_velocity = Vector2();
+	impulse_force = Vector2();
+}
+
+Vector2 Bullet::get_applied_force() const {
+	return impulse_force;
+}
+
 Vector2 Bullet::get_direction() const {
 	ERR_FAIL_COND_V_MSG(!path.is_valid(), Vector2(0,0), "Current path is invalid. Cannot return direction on invalid path.");
-	return path->get_direction(get_age());
+	if (_has_impulse()) {
+		return get_velocity().normalized();
+	}
+	if (path->is_homing()) {
+		return homing_velocity.normalized().rotated(heading);
+	}
+	return path->get_direction(get_age()).rotated(heading);
 }
 
 Vector2 Bullet::get_velocity() const {
 	ERR_FAIL_COND_V_MSG(!path.is_valid(), Vector2(0,0), "Current path is invalid. Cannot return velocity on invalid path.");
-	return path->get_velocity(get_age());
+	if (path->is_homing()) {
+		return homing_velocity.rotated(heading) * program_speed + impulse_velocity;
+	}
+	return path->get_velocity(get_age()).rotated(heading) * program_speed + impulse_velocity;
 }
 
 float Bullet::get_rotation() const {
 	ERR_FAIL_COND_V_MSG(!path.is_valid(), 0, "Current path is invalid. Cannot return rotation on invalid path.");
-	return path->get_rotation(get_age());
+	if (_has_impulse()) {
+		return get_velocity().angle();
+	}
+	if (path->is_homing()) {
+		return homing_velocity.angle() + heading;
+	}
+	return path->get_rotation(get_age()) + heading;
 }
 
 float Bullet::get_speed() const {
 	ERR_FAIL_COND_V_MSG(!path.is_valid(), 0, "Current path is invalid. Cannot return speed on invalid path.");
-	return path->get_speed(get_age());
+	if (_has_impulse()) {
+		return get_velocity().length();
+	}
+	if (path->is_homing()) {
+		return homing_velocity.length() * program_speed;
+	}
+	return path->get_speed(get_age()) * program_speed;
 }
 
 Transform2D Bullet::get_transform() const {
@@ -104,11 +154,38 @@ RID Bullet::get_ci_rid() const {
 }
 
 void Bullet::set_custom_data(const Dictionary &p_custom_data) {
-	custom_data = p_custom_data;
+	ERR_FAIL_NULL_MSG(data_table, "Custom data is stored by the BulletServer that owns this bullet.");
+	uint32_t id = data_table->acquire(p_custom_data, p_custom_data.is_empty() ? nullptr : p_custom_data.id(), data_id);
+	data_table->release(data_id);
+	data_id = id;
 }
 
 Dictionary Bullet::get_custom_data() const {
-	return custom_data;
+	return data_id ? data_table->get(data_id) : Dictionary();
+}
+
+void Bullet::set_payload_int(int p_slot, int32_t p_value) {
+	ERR_FAIL_NULL_MSG(payload_ints, "Payloads are stored by the BulletServer that owns this bullet.");
+	ERR_FAIL_INDEX(p_slot, BulletTexture::PAYLOAD_SLOTS);
+	payload_ints[p_slot * payload_stride] = p_value;
+}
+
+int32_t Bullet::get_payload_int(int p_slot) const {
+	ERR_FAIL_NULL_V_MSG(payload_ints, 0, "Payloads are stored by the BulletServer that owns this bullet.");
+	ERR_FAIL_INDEX_V(p_slot, BulletTexture::PAYLOAD_SLOTS, 0);
+	return payload_ints[p_slot * payload_stride];
+}
+
+void Bullet::set_payload_float(int p_slot, float p_value) {
+	ERR_FAIL_NULL_MSG(payload_floats, "Payloads are stored by the BulletServer that owns this bullet.");
+	ERR_FAIL_INDEX(p_slot, BulletTexture::PAYLOAD_SLOTS);
+	payload_floats[p_slot * payload_stride] = p_value;
+}
+
+float Bullet::get_payload_float(int p_slot) const {
+	ERR_FAIL_NULL_V_MSG(payload_floats, 0.0, "Payloads are stored by the BulletServer that owns this bullet.");
+	ERR_FAIL_INDEX_V(p_slot, BulletTexture::PAYLOAD_SLOTS, 0.0);
+	return payload_floats[p_slot * payload_stride];
 }
 
 void Bullet::_bind_methods() {
@@ -128,6 +205,11 @@ void Bullet::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_position", "position"), &Bullet::set_position);
 	ClassDB::bind_method(D_METHOD("get_position"), &Bullet::get_position);
 
+	ClassDB::bind_method(D_METHOD("apply_impulse", "impulse"), &Bullet::apply_impulse);
+	ClassDB::bind_method(D_METHOD("apply_force", "force"), &Bullet::apply_force);
+	ClassDB::bind_method(D_METHOD("clear_forces"), &Bullet::clear_forces);
+	ClassDB::bind_method(D_METHOD("get_applied_force"), &Bullet::get_applied_force);
+
 	ClassDB::bind_method(D_METHOD("get_direction"), &Bullet::get_direction);
 	ClassDB::bind_method(D_METHOD("get_velocity"), &Bullet::get_velocity);
 	ClassDB::bind_method(D_METHOD("get_rotation"), &Bullet::get_rotation);
@@ -140,6 +222,12 @@ void Bullet::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_custom_data", "data"), &Bullet::set_custom_data);
 	ClassDB::bind_method(D_METHOD("get_custom_data"), &Bullet::get_custom_data);
 
+	ClassDB::bind_method(D_METHOD("set_payload_int", "slot", "value"), &Bullet::set_payload_int);
+	ClassDB::bind_method(D_METHOD("get_payload_int", "slot"), &Bullet::get_payload_int);
+
+	ClassDB::bind_method(D_METHOD("set_payload_float", "slot", "value"), &Bullet::set_payload_float);
+	ClassDB::bind_method(D_METHOD("get_payload_float", "slot"), &Bullet::get_payload_float);
+
 	BIND_ENUM_CONSTANT(LIVE);
 	BIND_ENUM_CONSTANT(UNINITIALIZED);
 	BIND_ENUM_CONSTANT(POPPED_OUT_OF_BOUNDS);
@@ -147,16 +235,46 @@ void Bullet::_bind_methods() {
 	BIND_ENUM_CONSTANT(POPPED_LIFETIME_BULLET);
 	BIND_ENUM_CONSTANT(POPPED_COLLIDE);
 	BIND_ENUM_CONSTANT(POPPED_REQUESTED);
+	BIND_ENUM_CONSTANT(POPPED_CANCELLED);
 }
 
 Bullet::Bullet() {
 	ci_rid = RS::get_singleton()->canvas_item_create();
 	transform = Transform2D();
+	previous_transform = Transform2D();
+	motion = Vector2();
 	texture = Ref<BulletTexture>();
 	path = Ref<BulletPath>();
-	custom_data = Dictionary();
+	data_table = nullptr;
+	data_id = 0;
+	payload_ints = nullptr;
+	payload_floats = nullptr;
+	payload_stride = 0;
 	state = Bullet::UNINITIALIZED;
+	clock = nullptr;
 	spawntime = 0;
+	serial = 0;
+	path_start = 0;
+	path_state_id = 0;
+	texture_state_id = 0;
+	data_state_id = 0;
+	type_id = 0;
+	type_revision = 0;
+	program = Ref<BulletProgram>();
+	program_pc = 0;
+	program_wait = 0;
+	program_loop_pc = 0;
+	program_loop_left = 0;
+	program_ramp_ticks = 0;
+	program_speed = 1.0;
+	program_ramp = 0.0;
+	heading = 0.0;
+	emissions = 0;
+	homing_velocity = Vector2();
+	impulse_velocity = Vector2();
+	impulse_force = Vector2();
+	render_shown = false;
+	render_dirty = false;
 }
 
 Bullet::~Bullet() {
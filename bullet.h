@@ -1,6 +1,7 @@
 #ifndef BULLET_H
 #define BULLET_H
 
+#include "bullet_type_table.h"
 #include "resource/bullet_path.h"
 #include "resource/bullet_texture.h"
 #include "core/math/transform_2d.h"
@@ -17,16 +18,57 @@ public:
 		POPPED_LIFETIME_SERVER,
 		POPPED_LIFETIME_BULLET,
 		POPPED_COLLIDE,
-		POPPED_REQUESTED
+		POPPED_REQUESTED,
+		POPPED_CANCELLED
 	};
 
 private:
 	GDCLASS(Bullet, Object);
 
+	const uint64_t *clock;
 	uint64_t spawntime;
+	uint32_t serial;
 	uint64_t path_start;
 	State state;
 
+	uint32_t path_state_id;
+	uint32_t texture_state_id;
+	uint32_t data_state_id;
+
+	// the server's registered type for the texture, and the revision of it this bullet's canvas item was drawn with
+	uint16_t type_id;
+	uint32_t type_revision;
+
+	// registers of the texture's BulletProgram, advanced by the server each tick
+	Ref<BulletProgram> program;
+	uint16_t program_pc;
+	uint16_t program_wait;
+	uint16_t program_loop_pc;
+	uint16_t program_loop_left;
+	uint16_t program_ramp_ticks;
+	float program_speed;
+	float program_ramp;
+
+	// turns the shared path, so programs and emitted volleys can aim bullets without copying paths
+	float heading;
+	// current velocity of a bullet on a homing path, which only the server knows
+	Vector2 homing_velocity;
+	// impulses and forces applied on top of the path, kept here so changing motion allocates no paths
+	Vector2 impulse_velocity;
+	Vector2 impulse_force;
+	// distance moved during the current tick, swept by collision queries
+	Vector2 motion;
+	// transform at the start of the current tick, which rendering interpolates from
+	Transform2D previous_transform;
+	// whether the canvas item is shown, and whether its transform changed since it was last pushed
+	bool render_shown;
+	bool render_dirty;
+	// timed emissions made so far
+	uint32_t emissions;
+
+	uint64_t _get_clock_usec() const;
+	_FORCE_INLINE_ bool _has_impulse() const { return impulse_velocity != Vector2() || impulse_force != Vector2(); }
+
 	Transform2D transform;
 
 	Ref<BulletPath> path;
@@ -34,7 +76,14 @@ private:
 
 	RID ci_rid;
 
-	Dictionary custom_data;
+	// custom data is shared by every bullet spawned with it, through the owning server's table
+	BulletTypeTable<Dictionary> *data_table;
+	uint32_t data_id;
+
+	// payload slots live in the owning server, one array per slot, each bullet's values payload_stride apart
+	int32_t *payload_ints;
+	float *payload_floats;
+	uint32_t payload_stride;
 
 protected:
 	static void _bind_methods();
@@ -58,6 +107,11 @@ public:
 	void set_position(const Vector2 &p_position);
 	Vector2 get_position() const;
 
+	void apply_impulse(const Vector2 &p_impulse);
+	void apply_force(const Vector2 &p_force);
+	void clear_forces();
+	Vector2 get_applied_force() const;
+
 	Vector2 get_direction() const;
 	Vector2 get_velocity() const;
 	float get_rotation() const;
@@ -71,6 +125,12 @@ public:
 	void set_custom_data(const Dictionary &p_custom_data);
 	Dictionary get_custom_data() const;
 
+	void set_payload_int(int p_slot, int32_t p_value);
+	int32_t get_payload_int(int p_slot) const;
+
+	void set_payload_float(int p_slot, float p_value);
+	float get_payload_float(int p_slot) const;
+
 	Bullet();
 	~Bullet();
 };
@@ -0,0 +1,121 @@
+#include "bullet_atlas.h"
+
+bool BulletAtlas::_place(Page &r_page, const Size2i &p_size, Point2i &r_position) {
+	Size2i padded = p_size + Size2i(PADDING, PADDING) * 2;
+	if (r_page.shelf_x + padded.x > r_page.size) {
+		//start a new shelf under the tallest sprite of the current one
+		r_page.shelf_x = 0;
+		r_page.shelf_y += r_page.shelf_height;
+		r_page.shelf_height = 0;
+	}
+	if (padded.x > r_page.size || r_page.shelf_y + padded.y > r_page.size) {
+		return false;
+	}
+	r_position = Point2i(r_page.shelf_x + PADDING, r_page.shelf_y + PADDING);
+	r_page.shelf_x += padded.x;
+	r_page.shelf_height = MAX(r_page.shelf_height, padded.y);
+	return true;
+}
+
+int BulletAtlas::_add_page(int p_size) {
+	Page page;
+	page.size = p_size;
+	page.image = Image::create_empty(p_size, p_size, false, Image::FORMAT_RGBA8);
+	//the texture exists from the start so batches can be bound to it, and is filled in by commit()
+	page.texture = ImageTexture::create_from_image(page.image);
+	pages.push_back(page);
+	return pages.size() - 1;
+}
+
+bool BulletAtlas::add(const Ref<Texture2D> &p_texture, Region &r_region) {
+	ERR_FAIL_COND_V(p_texture.is_null(), false);
+	Sprite *existing = sprites.getptr(p_texture.ptr());
+	if (existing) {
+		existing->users++;
+		r_region = existing->region;
+		return true;
+	}
+
+	Ref<Image> image = p_texture->get_image();
+	ERR_FAIL_COND_V_MSG(image.is_null() || image->is_empty(), false, "Bullet sprite has no image data and can't be packed into an atlas.");
+	if (image->is_compressed() || image->get_format() != Image::FORMAT_RGBA8) {
+		//never convert the source in place, some textures hand out their own image
+		image = image->duplicate();
+		if (image->is_compressed()) {
+			image->decompress();
+		}
+		image->convert(Image::FORMAT_RGBA8);
+	}
+	Size2i size = image->get_size();
+
+	//only the last page and emptied ones still have room worth looking for, the rest were closed when the next was opened
+	int page = -1;
+	Point2i position;
+	for (int i = pages.size() - 1; i >= 0; i--) {
+		bool open = pages[i].sprites == 0 || (i == (int)pages.size() - 1 && pages[i].size == PAGE_SIZE);
+		if (open && _place(pages[i], size, position)) {
+			page = i;
+			break;
+		}
+	}
+	if (page < 0) {
+		int needed = MAX(size.x, size.y) + PADDING * 2;
+		page = _add_page(MAX(needed, PAGE_SIZE));
+		_place(pages[page], size, position);
+	}
+
+	Page &target = pages[page];
+	target.image->blit_rect(image, Rect2i(Point2i(), size), position);
+	target.sprites++;
+	target.dirty = true;
+
+	Sprite sprite;
+	sprite.region.page = page;
+	sprite.region.uv = Rect2(Vector2(position) / target.size, Vector2(size) / target.size);
+	sprite.region.size = size;
+	sprite.source = p_texture;
+	sprite.users = 1;
+	sprites.insert(p_texture.ptr(), sprite);
+	r_region = sprite.region;
+	return true;
+}
+
+void BulletAtlas::release(const Ref<Texture2D> &p_texture) {
+	Sprite *sprite = sprites.getptr(p_texture.ptr());
+	if (sprite == nullptr || --sprite->users > 0) {
+		return;
+	}
+	Page &page = pages[sprite->region.page];
+	sprites.erase(p_texture.ptr());
+	if (--page.sprites == 0) {
+		//cleared so filtering around the next sprites placed here never picks up old pixels
+		page.image->fill(Color(0, 0, 0, 0));
+		page.shelf_x = 0;
+		page.shelf_y = 0;
+		page.shelf_height = 0;
+		page.dirty = true;
+	}
+}
+
+void BulletAtlas::commit() {
+	for (uint32_t i = 0; i < pages.size(); i++) {
+		if (pages[i].dirty) {
+			pages[i].texture->update(pages[i].image);
+			pages[i].dirty = false;
+		}
+	}
+}
+
+RID BulletAtlas::get_page_rid(int p_page) const {
+	ERR_FAIL_INDEX_V(p_page, (int)pages.size(), RID());
+	return pages[p_page].texture->get_rid();
+}
+
+int BulletAtlas::get_page_count() const {
+	return pages.size();
+}
+
+void BulletAtlas::clear() {
+	pages.clear();
+	sprites.clear();
+}
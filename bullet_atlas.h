@@ -0,0 +1,64 @@
+#ifndef BULLETATLAS_H
+#define BULLETATLAS_H
+
+#include "core/io/image.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "scene/resources/image_texture.h"
+
+// Packs bullet sprites into shared atlas pages, so bullets with different
+// textures can be drawn by one batch per page. Sprites are placed on shelves
+// as they are first added and never move, so their regions stay valid until
+// they are released as often as they were added. Shelves can't reuse the
+// holes released sprites leave, so a page is reclaimed once its last sprite
+// is released. Sprites larger than a page get a page of their own.
+class BulletAtlas {
+public:
+	struct Region {
+		int page = 0;
+		// normalized to the page, ready to be used as instance data
+		Rect2 uv;
+		Size2 size;
+	};
+
+	static const int PAGE_SIZE = 2048;
+	// transparent border kept around every sprite so filtering never samples a neighbour
+	static const int PADDING = 2;
+
+private:
+	struct Page {
+		Ref<Image> image;
+		Ref<ImageTexture> texture;
+		int size = 0;
+		int shelf_x = 0;
+		int shelf_y = 0;
+		int shelf_height = 0;
+		int sprites = 0;
+		bool dirty = false;
+	};
+
+	struct Sprite {
+		Region region;
+		// kept referenced so a new texture can't reuse the address of a packed one
+		Ref<Texture2D> source;
+		int users = 0;
+	};
+
+	LocalVector<Page> pages;
+	HashMap<const Texture2D *, Sprite> sprites;
+
+	bool _place(Page &r_page, const Size2i &p_size, Point2i &r_position);
+	int _add_page(int p_size);
+
+public:
+	bool add(const Ref<Texture2D> &p_texture, Region &r_region);
+	void release(const Ref<Texture2D> &p_texture);
+	void commit();
+
+	RID get_page_rid(int p_page) const;
+	int get_page_count() const;
+
+	void clear();
+};
+
+#endif
@@ -1,10 +1,74 @@
 #include "bullet_server.h"
 
+#include "bullet_tracer.h"
+
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
 #include "core/os/time.h"
 #include "core/object/ref_counted.h"
+#include "main/performance.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/scene_tree.h"
 #include "scene/main/viewport.h"
+#include "scene/resources/material.h"
 #include "scene/resources/world_2d.h"
 
+// Monitors are compiled in unless the module is built for a release template
+// with qurobullet_monitors_in_release=no (see SCsub).
+#ifdef QUROBULLET_MONITORS_ENABLED
+#define MONITOR_COUNT(m_monitor, m_amount)            \
+	do {                                              \
+		if (monitors_enabled) {                       \
+			_monitor_counters[m_monitor] += m_amount; \
+		}                                             \
+	} while (0)
+#define MONITOR_TICKS() (monitors_enabled ? OS::get_singleton()->get_ticks_usec() : 0)
+#else
+#define MONITOR_COUNT(m_monitor, m_amount) (void)(m_amount)
+#define MONITOR_TICKS() 0
+#endif
+
+static const char *monitor_names[BulletServer::MONITOR_MAX] = {
+	"live_bullets",
+	"spawned",
+	"recycled",
+	"popped_out_of_bounds",
+	"popped_lifetime_server",
+	"popped_lifetime_bullet",
+	"popped_collide",
+	"popped_requested",
+	"popped_cancelled",
+	"integration_time_ms",
+	"collision_time_ms",
+	"report_time_ms",
+	"render_time_ms",
+	"governor_level",
+};
+
+//the governor only steps back down once ticks come in comfortably under budget
+#define GOVERNOR_RECOVERY_RATIO 0.75
+//a server running its own tick rate drops the backlog rather than spiral after a long hitch
+#define SIM_MAX_TICKS_PER_FRAME 8
+//bullet cancellation grids never use cells smaller than this, however small the bullets
+#define CANCEL_MIN_CELL_SIZE 8.0
+//catching up an aged spawn takes at most this many path steps, which grow past a tick for very old bullets
+#define SPAWN_CATCH_UP_MAX_STEPS 600
+//ages from the network or a log are capped, so the clock arithmetic below can't overflow
+#define SPAWN_MAX_AGE 3600.0
+//bullets are drawn under the render root in order of layer, then of type, so each layer leaves room for every type id
+#define DRAW_LAYER_STRIDE 65536
+
+#define STATE_MAGIC 0x54534251 // "QBST"
+#define STATE_DELTA_MAGIC 0x44534251 // "QBSD"
+#define STATE_VERSION 9
+#define STATE_HEADER_SIZE 44
+//each record ends with the generations of its path, texture and data ids
+#define STATE_BULLET_GENERATIONS (105 + BulletTexture::PAYLOAD_SLOTS * 8)
+#define STATE_BULLET_SIZE (STATE_BULLET_GENERATIONS + 12)
+#define STATE_SCHEDULED_SIZE 38
+//pattern runners are followed by their open loops, 8 bytes each
+#define STATE_PATTERN_SIZE 63
+
 void BulletServer::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_READY: {
@@ -22,13 +86,23 @@ void BulletServer::_notification(int p_what) {
 			
 			_uninit_bullets();
 			_init_bullets();
+			if (get_scheduled_spawn_count() == 0) {
+				_wheel_tick_usec = MAX(1000000 / _get_ticks_per_second(), 1);
+				_wheel_tick = _sim_clock / _wheel_tick_usec + 1;
+			}
+
+			if (monitors_enabled) {
+				_register_monitors();
+			}
 		} break;
 
 		case NOTIFICATION_PROCESS: {
-			//update bullet canvasitems
-			for (int i = 0; i < live_bullet_count; i++) {
-				Bullet *bullet = bullet_pool[i];
-				RS::get_singleton()->canvas_item_set_transform(bullet->get_ci_rid(), bullet->get_transform());
+			uint64_t render_start = (monitors_enabled || budget_msec > 0) ? OS::get_singleton()->get_ticks_usec() : 0;
+			_sync_render();
+			if (render_start != 0) {
+				uint64_t render_usec = OS::get_singleton()->get_ticks_usec() - render_start;
+				_governor_render_usec += render_usec;
+				MONITOR_COUNT(MONITOR_RENDER_TIME, render_usec);
 			}
 		} break;
 
@@ -36,11 +110,36 @@ void BulletServer::_notification(int p_what) {
 			if (Engine::get_singleton()->is_editor_hint()) {
 				return;
 			}
-			_update_play_area();
-			_process_bullets(get_physics_process_delta_time());
+			uint64_t tick_start = budget_msec > 0 ? OS::get_singleton()->get_ticks_usec() : 0;
+			//a fixed step keeps time_scale and frame hitches out of the simulation
+			_sim_frame_step = deterministic ? 1.0 / Engine::get_singleton()->get_physics_ticks_per_second() : get_physics_process_delta_time();
+			int ticks = 1;
+			if (sim_ticks_per_second > 0) {
+				//the server keeps its own fixed rate, running as many ticks as the physics frame covers
+				double step = 1.0 / sim_ticks_per_second;
+				_sim_accumulator += _sim_frame_step;
+				ticks = 0;
+				while (_sim_accumulator >= step && ticks < SIM_MAX_TICKS_PER_FRAME) {
+					_tick(step);
+					_sim_accumulator -= step;
+					ticks++;
+				}
+				if (_sim_accumulator >= step) {
+					_sim_accumulator = Math::fmod(_sim_accumulator, step);
+				}
+			} else {
+				_tick(_sim_frame_step);
+			}
+			if (tick_start != 0 && ticks > 0) {
+				_update_governor(OS::get_singleton()->get_ticks_usec() - tick_start);
+			}
 		} break;
 
 		case NOTIFICATION_EXIT_TREE: {
+			_unregister_monitors();
+			stop_recording();
+			stop_replay();
+			clear_scheduled_spawns();
 			_uninit_bullets();
 		} break;
 
@@ -60,70 +159,222 @@ void build_popped_dict (Bullet* bullet, Array out) {
 	out.append(dict);
 }
 
+void BulletServer::_tick(float delta) {
+	_update_play_area();
+	if (_replay_log.is_open()) {
+		_replay_spawns();
+	}
+	if (!_patterns.is_empty()) {
+		_run_patterns();
+	}
+	_process_bullets(delta);
+}
+
 void BulletServer::_process_bullets(float delta) {
 	ERR_FAIL_COND(!is_inside_tree());
 
+	_publish_monitors();
+
+	if (render_interpolation) {
+		for (int i = 0; i < live_bullet_count; i++) {
+			bullet_pool[i]->previous_transform = bullet_pool[i]->transform;
+		}
+	}
+
 	PhysicsDirectSpaceState2D* space_state = get_viewport()->find_world_2d()->get_direct_space_state();
 	Dictionary collision_info = Dictionary();
 	Array popped_bullets = Array();
 
+	_collision_queue.clear();
+	_popped_queue.clear();
+	_homing_queue.clear();
+	_tick_count++;
+
+	if (!deterministic && _governor_level >= GOVERNOR_STAGGER_COLLISIONS) {
+		_update_focus_positions();
+	}
+
+	BulletTracer *tracer = BulletTracer::get_singleton();
+	uint64_t trace_start = tracer->begin_span();
+	int processed_count = live_bullet_count;
+
+	uint64_t integration_start = MONITOR_TICKS();
+
+	//the pool is walked from the newest live slot down, and pops only swap in slots that were already visited,
+	//so the order bullets move, collide and are reported in depends on nothing but the spawn and pop history
 	for (int i = live_bullet_count - 1; i >= 0; i--) {
 		Bullet* bullet = bullet_pool[i];
+		if (bullet->program.is_valid() && !bullet->is_popped()) {
+			_step_bullet_program(bullet);
+		}
 		Ref<BulletPath> path = bullet->get_path();
 
 		if (bullet->is_popped()) {
-			build_popped_dict(bullet, popped_bullets);
-			_free_bullet(i);
+			_pop_bullet(i);
 		} else if (max_lifetime >= 0.001 && bullet->get_age() > max_lifetime) {
 			bullet->state = Bullet::POPPED_LIFETIME_SERVER;
-			build_popped_dict(bullet, popped_bullets);
-			_free_bullet(i);
+			_pop_bullet(i);
 		} else if (path.is_valid() && path->get_lifetime() >= 0.001 && bullet->get_path_time() > path->get_lifetime()) {
 			bullet->state = Bullet::POPPED_LIFETIME_BULLET;
-			build_popped_dict(bullet, popped_bullets);
-			_free_bullet(i);
-		} else if ((play_area_mode == INFINITE || play_area_rect.has_point(bullet->get_position()) && path.is_valid())) {
-			bullet->set_position(bullet->get_position() + path->get_step(bullet->get_path_time(), delta));
-			_handle_collisions(bullet, space_state, collision_info);
-		} else if (_bullet_trajectory_valid(bullet->get_position(), bullet->get_direction()) && path.is_valid()) {
-			bullet->set_position(bullet->get_position() + path->get_step(bullet->get_path_time(), delta));
+			_pop_bullet(i);
+		} else if (path.is_valid()) {
+			if (path->is_homing()) {
+				_homing_queue.push_back(bullet);
+			} else {
+				bullet->motion = _get_bullet_step(bullet, path, delta);
+				bullet->set_position(bullet->get_position() + bullet->motion);
+			}
 		} else {
 			bullet->state = Bullet::POPPED_OUT_OF_BOUNDS;
-			build_popped_dict(bullet, popped_bullets);
-			_free_bullet(i);
+			_pop_bullet(i);
+		}
+	}
+	_restore_heap();
+
+	if (!_homing_queue.is_empty()) {
+		_steer_homing_bullets(delta);
+	}
+
+	//bullets are checked against the play area where they ended up, after everything has moved
+	_classify_play_area();
+	_emit_timed_volleys();
+	_cancel_grid_dirty = true;
+
+	//bullets spawned from here on, including by signal handlers, start at the new time
+	_sim_clock += (uint64_t)Math::round(delta * 1000000.0);
+	_expire_pop_effects();
+
+	uint64_t collision_start = MONITOR_TICKS();
+	trace_start = tracer->end_span("process_bullets", this, trace_start, processed_count);
+
+	//collisions are checked after every bullet has moved, so the integration and query phases can be timed separately
+	for (uint32_t i = 0; i < _collision_queue.size(); i++) {
+		if (!deterministic && _governor_level >= GOVERNOR_STAGGER_COLLISIONS && _should_stagger_collision(_collision_queue[i])) {
+			continue;
 		}
+		_handle_collisions(_collision_queue[i], space_state, collision_info);
+	}
+
+	Array cancelled_bullets = Array();
+	if (!_cancel_servers.is_empty()) {
+		_cancel_bullets(cancelled_bullets);
+	}
+
+	uint64_t report_start = MONITOR_TICKS();
+	trace_start = tracer->end_span("handle_collisions", this, trace_start, _collision_queue.size());
+
+	//popped bullets keep their data until respawned, so reports must be built before any signal handler can spawn
+	for (uint32_t i = 0; i < _popped_queue.size(); i++) {
+		build_popped_dict(_popped_queue[i], popped_bullets);
 	}
+	_spawn_children();
+	_expire_scheduled_spawns();
 
 	if (!collision_info.is_empty()) {
 		emit_signal("collisions_detected", collision_info);
 	}
 
+	if (!cancelled_bullets.is_empty()) {
+		emit_signal("bullets_cancelled", cancelled_bullets);
+	}
+
 	if (!popped_bullets.is_empty()) {
 		emit_signal("bullets_popped", popped_bullets);
 	}
+
+	uint64_t report_end = MONITOR_TICKS();
+	tracer->end_span("report_pops", this, trace_start, _popped_queue.size());
+	MONITOR_COUNT(MONITOR_INTEGRATION_TIME, collision_start - integration_start);
+	MONITOR_COUNT(MONITOR_COLLISION_TIME, report_start - collision_start);
+	MONITOR_COUNT(MONITOR_REPORT_TIME, report_end - report_start);
+}
+
+void BulletServer::_pop_bullet(int index) {
+	Bullet* bullet = bullet_pool[index];
+	switch (bullet->state) {
+		case Bullet::POPPED_OUT_OF_BOUNDS: {
+			MONITOR_COUNT(MONITOR_POPPED_OUT_OF_BOUNDS, 1);
+		} break;
+		case Bullet::POPPED_LIFETIME_SERVER: {
+			MONITOR_COUNT(MONITOR_POPPED_LIFETIME_SERVER, 1);
+		} break;
+		case Bullet::POPPED_LIFETIME_BULLET: {
+			MONITOR_COUNT(MONITOR_POPPED_LIFETIME_BULLET, 1);
+		} break;
+		case Bullet::POPPED_COLLIDE: {
+			MONITOR_COUNT(MONITOR_POPPED_COLLIDE, 1);
+		} break;
+		case Bullet::POPPED_REQUESTED: {
+			MONITOR_COUNT(MONITOR_POPPED_REQUESTED, 1);
+		} break;
+		case Bullet::POPPED_CANCELLED: {
+			MONITOR_COUNT(MONITOR_POPPED_CANCELLED, 1);
+		} break;
+		default:
+			break;
+	}
+	_popped_queue.push_back(bullet);
+	if (bullet->texture.is_valid() && bullet->state >= Bullet::POPPED_OUT_OF_BOUNDS) {
+		int reason = 1 << (bullet->state - Bullet::POPPED_OUT_OF_BOUNDS);
+		if (bullet->texture->emits_on_pop(reason)) {
+			_queue_child_spawn(bullet);
+		}
+		if (bullet->texture->has_pop_effect(reason)) {
+			_start_pop_effect(bullet);
+		}
+	}
+	_free_bullet(index);
 }
 
 void BulletServer::_handle_collisions(Bullet* bullet, PhysicsDirectSpaceState2D* space_state, Dictionary out) {
-	if (!bullet->can_collide()) {
+	if (bullet->is_popped()) {
+		return;
+	}
+	if (!_update_bullet_type(bullet)) {
+		return;
+	}
+	const BulletType &type = _types[bullet->type_id];
+	if (!type.shape_rid.is_valid() || type.collision_mask == 0) {
 		return;
 	}
 	Vector<PhysicsDirectSpaceState2D::ShapeResult> results = Vector<PhysicsDirectSpaceState2D::ShapeResult>();
 	results.resize(max_collisions_per_bullet);
 
-	Ref<BulletTexture> b_tex = bullet->get_texture();
 	PhysicsDirectSpaceState2D::ShapeParameters shape_params = PhysicsDirectSpaceState2D::ShapeParameters();
 
-	shape_params.shape_rid = b_tex->get_collision_shape()->get_rid();
+	shape_params.shape_rid = type.shape_rid;
 	shape_params.transform = bullet->get_transform();
 	shape_params.motion = Vector2(0, 0);
 	shape_params.margin = 0.0;
 	shape_params.exclude = HashSet<RID>();
-	shape_params.collision_mask = b_tex->get_collision_mask();
-	shape_params.collide_with_bodies = b_tex->get_collision_detect_bodies();
-	shape_params.collide_with_areas = b_tex->get_collision_detect_areas();
-
-
-	int collisions = space_state->intersect_shape(shape_params, results.ptrw(), results.size());
+	shape_params.collision_mask = type.collision_mask;
+	shape_params.collide_with_bodies = type.collision_detect_bodies;
+	shape_params.collide_with_areas = type.collision_detect_areas;
+
+	int collisions = 0;
+	Vector2 motion = bullet->motion;
+	if (!sweep_collisions || motion == Vector2()) {
+		collisions = space_state->intersect_shape(shape_params, results.ptrw(), results.size());
+	} else {
+		//the shape is swept from where the bullet started the tick, so fast bullets can't skip over thin colliders
+		int substeps = 1;
+		if (pop_on_collide && max_collision_substeps > 1) {
+			//bullets moving further than their own size are swept in pieces, so they stop at the first thing they hit
+			//instead of reporting everything along the whole step
+			if (type.shape_reach > CMP_EPSILON) {
+				substeps = CLAMP((int)Math::ceil(motion.length() / type.shape_reach), 1, max_collision_substeps);
+			}
+		}
+		Vector2 start = bullet->get_position() - motion;
+		shape_params.motion = motion / substeps;
+		for (int i = 0; i < substeps && collisions == 0; i++) {
+			shape_params.transform.set_origin(start + shape_params.motion * i);
+			collisions = space_state->intersect_shape(shape_params, results.ptrw(), results.size());
+			if (collisions > 0 && i < substeps - 1) {
+				bullet->set_position(start + shape_params.motion * (i + 1));
+			}
+		}
+	}
 	if (collisions > 0) {
 		Array list = Array();
 		for (int i = 0; i < collisions; i++) {
@@ -142,12 +393,174 @@ void BulletServer::_handle_collisions(Bullet* bullet, PhysicsDirectSpaceState2D*
 	}
 }
 
+static _FORCE_INLINE_ uint32_t _cancel_cell_hash(int p_x, int p_y) {
+	return hash_murmur3_one_32(p_y, hash_murmur3_one_32(p_x));
+}
+
+void BulletServer::_build_cancel_grid(float p_query_radius) {
+	_cancel_grid_dirty = false;
+	_cancel_query_radius = p_query_radius;
+	_cancel_entries.clear();
+	_cancel_max_radius = 0.0;
+	for (int i = 0; i < live_bullet_count; i++) {
+		Bullet *bullet = bullet_pool[i];
+		if (bullet->is_popped() || !_update_bullet_type(bullet)) {
+			continue;
+		}
+		const BulletType &type = _types[bullet->type_id];
+		if (type.cancel_layer == 0) {
+			continue;
+		}
+		CancelEntry entry;
+		entry.position = bullet->get_position();
+		entry.radius = type.cancel_radius;
+		entry.layer = type.cancel_layer;
+		entry.bucket = 0;
+		entry.bullet = bullet;
+		_cancel_entries.push_back(entry);
+		_cancel_max_radius = MAX(_cancel_max_radius, type.cancel_radius);
+	}
+
+	//cells as wide as the largest radii of both sides keep most queries to a 3x3 block of cells
+	_cancel_cell_size = MAX(_cancel_max_radius + p_query_radius, CANCEL_MIN_CELL_SIZE);
+	uint32_t bucket_count = next_power_of_2(MAX(_cancel_entries.size(), 1u));
+	_cancel_buckets.resize(bucket_count + 1);
+	for (uint32_t i = 0; i < _cancel_buckets.size(); i++) {
+		_cancel_buckets[i] = 0;
+	}
+	for (uint32_t i = 0; i < _cancel_entries.size(); i++) {
+		CancelEntry &entry = _cancel_entries[i];
+		entry.bucket = _cancel_cell_hash(Math::floor(entry.position.x / _cancel_cell_size), Math::floor(entry.position.y / _cancel_cell_size)) & (bucket_count - 1);
+		_cancel_buckets[entry.bucket + 1]++;
+	}
+	for (uint32_t i = 1; i <= bucket_count; i++) {
+		_cancel_buckets[i] += _cancel_buckets[i - 1];
+	}
+
+	//counting sort, so each bucket's entries are contiguous and a query touches no pointers until it finds a match
+	_cancel_grid.resize(_cancel_entries.size());
+	for (uint32_t i = 0; i < _cancel_entries.size(); i++) {
+		_cancel_grid[_cancel_buckets[_cancel_entries[i].bucket]++] = _cancel_entries[i];
+	}
+	for (uint32_t i = bucket_count; i > 0; i--) {
+		_cancel_buckets[i] = _cancel_buckets[i - 1];
+	}
+	_cancel_buckets[0] = 0;
+}
+
+Bullet *BulletServer::_find_cancel_target(const Vector2 &p_position, float p_radius, uint32_t p_mask, const Bullet *p_exclude) const {
+	float reach = p_radius + _cancel_max_radius;
+	uint32_t bucket_mask = _cancel_buckets.size() - 2;
+	int x0 = Math::floor((p_position.x - reach) / _cancel_cell_size);
+	int x1 = Math::floor((p_position.x + reach) / _cancel_cell_size);
+	int y0 = Math::floor((p_position.y - reach) / _cancel_cell_size);
+	int y1 = Math::floor((p_position.y + reach) / _cancel_cell_size);
+	auto find_in = [&](uint32_t p_begin, uint32_t p_end) -> Bullet * {
+		for (uint32_t i = p_begin; i < p_end; i++) {
+			const CancelEntry &entry = _cancel_grid[i];
+			if (!(entry.layer & p_mask) || entry.bullet == p_exclude || entry.bullet->is_popped()) {
+				continue;
+			}
+			float range = p_radius + entry.radius;
+			if (p_position.distance_squared_to(entry.position) <= range * range) {
+				return entry.bullet;
+			}
+		}
+		return nullptr;
+	};
+
+	//a query covering more cells than there are buckets reads every bucket once instead
+	if ((int64_t)(x1 - x0 + 1) * (y1 - y0 + 1) > (int64_t)bucket_mask + 1) {
+		return find_in(0, _cancel_grid.size());
+	}
+	for (int y = y0; y <= y1; y++) {
+		for (int x = x0; x <= x1; x++) {
+			uint32_t bucket = _cancel_cell_hash(x, y) & bucket_mask;
+			Bullet *target = find_in(_cancel_buckets[bucket], _cancel_buckets[bucket + 1]);
+			if (target != nullptr) {
+				return target;
+			}
+		}
+	}
+	return nullptr;
+}
+
+void BulletServer::_cancel_bullets(Array &r_cancelled) {
+	float query_radius = 0.0;
+	for (uint32_t i = 1; i < _types.size(); i++) {
+		if (_types[i].texture.is_valid() && _types[i].cancel_mask != 0) {
+			query_radius = MAX(query_radius, _types[i].cancel_radius);
+		}
+	}
+
+	for (uint32_t s = 0; s < _cancel_servers.size();) {
+		BulletServer *other = Object::cast_to<BulletServer>(ObjectDB::get_instance(_cancel_servers[s]));
+		if (other == nullptr) {
+			//freed servers drop out of the list on their own
+			_cancel_servers.remove_at(s);
+			continue;
+		}
+		s++;
+		if (other->bullet_pool == nullptr) {
+			continue;
+		}
+		//grids are rebuilt for a server querying with larger radii than they were sized for
+		if (other->_cancel_grid_dirty || query_radius > other->_cancel_query_radius) {
+			other->_build_cancel_grid(query_radius);
+		}
+		if (other->_cancel_grid.is_empty()) {
+			continue;
+		}
+
+		//each bullet cancels at most the first bullet it touches, in the same pool order as every other pass
+		for (int i = live_bullet_count - 1; i >= 0; i--) {
+			Bullet *bullet = bullet_pool[i];
+			if (bullet->is_popped() || !_update_bullet_type(bullet)) {
+				continue;
+			}
+			const BulletType &type = _types[bullet->type_id];
+			if (type.cancel_mask == 0) {
+				continue;
+			}
+			Bullet *target = other->_find_cancel_target(bullet->get_position(), type.cancel_radius, type.cancel_mask, bullet);
+			if (target == nullptr) {
+				continue;
+			}
+			Dictionary dict = Dictionary();
+			dict["bullet"] = bullet;
+			dict["other_bullet"] = target;
+			dict["other_server"] = other;
+			r_cancelled.append(dict);
+
+			//both sides are popped by their own servers on their next tick, like bullets that collided
+			if (cancel_pop) {
+				bullet->pop();
+				bullet->state = Bullet::POPPED_CANCELLED;
+				target->pop();
+				target->state = Bullet::POPPED_CANCELLED;
+			}
+		}
+	}
+}
+
 void BulletServer::_init_bullets() {
 	ERR_FAIL_COND(!is_inside_tree());
 	bullet_pool = memnew_arr(Bullet*, bullet_pool_size);
+	_payload_ints.resize(bullet_pool_size * BulletTexture::PAYLOAD_SLOTS);
+	_payload_floats.resize(bullet_pool_size * BulletTexture::PAYLOAD_SLOTS);
+	_effects.reserve(render_effect_pool_size);
+	_render_root = RS::get_singleton()->canvas_item_create();
+	RS::get_singleton()->canvas_item_set_parent(_render_root, get_viewport()->find_world_2d()->get_canvas());
 	for (int i = 0; i < bullet_pool_size; ++i) {
 		bullet_pool[i] = memnew(Bullet);
-		RS::get_singleton()->canvas_item_set_parent(bullet_pool[i]->get_ci_rid(), get_viewport()->find_world_2d()->get_canvas());
+		bullet_pool[i]->clock = &_sim_clock;
+		bullet_pool[i]->data_table = &_custom_data;
+		bullet_pool[i]->payload_ints = _payload_ints.ptr() + i;
+		bullet_pool[i]->payload_floats = _payload_floats.ptr() + i;
+		bullet_pool[i]->payload_stride = bullet_pool_size;
+		RS::get_singleton()->canvas_item_set_parent(bullet_pool[i]->get_ci_rid(), _render_root);
+		RS::get_singleton()->canvas_item_set_visible(bullet_pool[i]->get_ci_rid(), false);
+		RS::get_singleton()->canvas_item_set_draw_index(bullet_pool[i]->get_ci_rid(), 0);
 	}
 }
 
@@ -159,15 +572,73 @@ void BulletServer::_uninit_bullets() {
 	}
 	memdelete_arr(bullet_pool);
 	bullet_pool = nullptr;
+	live_bullet_count = 0;
+	_heap_dirty = false;
+	_effects.clear();
+	_cancel_entries.clear();
+	_cancel_grid.clear();
+	_cancel_buckets.clear();
+	_cancel_grid_dirty = true;
+	_clear_types();
+	_free_batches();
+	RS::get_singleton()->free(_render_root);
+	_render_root = RID();
+	_custom_data.clear();
+	_last_data_id = 0;
+	_payload_ints.clear();
+	_payload_floats.clear();
+
+	_state_paths.clear();
+	_state_textures.clear();
+	_state_data.clear();
+	_state_patterns.clear();
+	_patterns.clear();
+	_started_patterns.clear();
 }
 
 void BulletServer::_free_bullet(int index) {
 	Bullet* bullet = bullet_pool[index];
-	RS::get_singleton()->canvas_item_set_visible(bullet->get_ci_rid(), false);
+	if (bullet->render_shown) {
+		RS::get_singleton()->canvas_item_set_visible(bullet->get_ci_rid(), false);
+		bullet->render_shown = false;
+	}
 
 	bullet_pool[index] = bullet_pool[live_bullet_count-1];
 	bullet_pool[live_bullet_count-1] = bullet;
 	live_bullet_count--;
+	//pops happen mid-sweep, and sweeps walk the pool from the top down. sifting down only ever moves bullets between
+	//slots already visited, but sifting up could move an unvisited one behind the sweep, so that waits for a rebuild
+	if (index < live_bullet_count) {
+		_heapify(index);
+		if (index > 0 && bullet_pool[(index - 1) / 2]->spawntime > bullet_pool[index]->spawntime) {
+			_heap_dirty = true;
+		}
+	}
+}
+
+void BulletServer::_restore_heap() {
+	if (!_heap_dirty) {
+		return;
+	}
+	_heap_dirty = false;
+	for (int i = MIN(live_bullet_count, bullet_pool_size) / 2 - 1; i >= 0; i--) {
+		_heapify(i);
+	}
+}
+
+void BulletServer::_heap_update(int index) {
+	if (index >= MIN(live_bullet_count, bullet_pool_size)) {
+		return;
+	}
+	//aged spawns and bullets moved in from the end of the heap can be older than their parents
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+		if (bullet_pool[parent]->spawntime <= bullet_pool[index]->spawntime) {
+			break;
+		}
+		SWAP(bullet_pool[parent], bullet_pool[index]);
+		index = parent;
+	}
 	_heapify(index);
 }
 
@@ -211,153 +682,1761 @@ void BulletServer::_update_play_area() {
 #define OUTCODE_LEFT 4
 #define OUTCODE_RIGHT 8
 
-int _compute_out_code(const Rect2 &p_rect, const Vector2 &p_pos) {
-	int out_code = 0;
+//branchless, so the batched loop below can be vectorized by the compiler
+static _FORCE_INLINE_ int _compute_out_code(float p_left, float p_top, float p_right, float p_bottom, const Vector2 &p_pos) {
+	return (p_pos.y < p_top) * OUTCODE_UP | (p_pos.y > p_bottom) * OUTCODE_DOWN | (p_pos.x < p_left) * OUTCODE_LEFT | (p_pos.x > p_right) * OUTCODE_RIGHT;
+}
+
+static _FORCE_INLINE_ int _compute_out_code(const Rect2 &p_rect, const Vector2 &p_pos) {
+	return _compute_out_code(p_rect.position.x, p_rect.position.y, p_rect.position.x + p_rect.size.x, p_rect.position.y + p_rect.size.y, p_pos);
+}
 
-	if (p_pos.y < p_rect.position.y) {
-		out_code |= OUTCODE_UP;
-	} else if (p_pos.y > p_rect.position.y + p_rect.size.y) {
-		out_code |= OUTCODE_DOWN;
+static void _compute_out_codes(const Rect2 &p_rect, const Vector2 *p_positions, uint8_t *r_codes, int p_count) {
+	float left = p_rect.position.x;
+	float top = p_rect.position.y;
+	float right = p_rect.position.x + p_rect.size.x;
+	float bottom = p_rect.position.y + p_rect.size.y;
+	for (int i = 0; i < p_count; i++) {
+		r_codes[i] = _compute_out_code(left, top, right, bottom, p_positions[i]);
 	}
+}
 
-	if (p_pos.x < p_rect.position.x) {
-		out_code |= OUTCODE_LEFT;
-	} else if (p_pos.x > p_rect.position.x + p_rect.size.x) {
-		out_code |= OUTCODE_RIGHT;
-	}
+bool BulletServer::_bullet_trajectory_valid(const Vector2 &p_pos, const Vector2 &p_dir, int p_out_code) const {
+	if (p_out_code == 0) { return true; }
+	if (!play_area_allow_incoming) { return false; }
+
+	//any point further away than the whole play area will do, so a manhattan bound saves the square roots
+	Vector2 to_center = play_area_rect.get_center() - p_pos;
+	float reach = Math::abs(to_center.x) + Math::abs(to_center.y) + play_area_rect.size.x + play_area_rect.size.y;
+	int clip_dest = _compute_out_code(play_area_rect, p_pos + reach * p_dir);
 
-	return out_code;
+	if ((p_out_code & clip_dest) != 0) { return false; }
+
+	return true;
 }
 
-bool BulletServer::_bullet_trajectory_valid(const Vector2 &p_pos, const Vector2 &p_dir) const {
-	if (play_area_mode == INFINITE) { return true; }
+void BulletServer::_classify_play_area() {
+	if (play_area_mode == INFINITE) {
+		for (int i = live_bullet_count - 1; i >= 0; i--) {
+			_collision_queue.push_back(bullet_pool[i]);
+		}
+	} else {
+		//positions are packed first so the out-codes are computed in one tight loop rather than bullet by bullet
+		_area_positions.resize(live_bullet_count);
+		_area_codes.resize(live_bullet_count);
+		for (int i = 0; i < live_bullet_count; i++) {
+			_area_positions[i] = bullet_pool[i]->get_position();
+		}
+		_compute_out_codes(play_area_rect, _area_positions.ptr(), _area_codes.ptr(), live_bullet_count);
+
+		//walked from the top down like the integration loop, so pops only swap in slots already classified
+		for (int i = live_bullet_count - 1; i >= 0; i--) {
+			Bullet *bullet = bullet_pool[i];
+			int out_code = _area_codes[i];
+			if (out_code != 0) {
+				if (play_area_exit_mode == EXIT_WRAP) {
+					_wrap_bullet(bullet);
+				} else if (play_area_exit_mode == EXIT_BOUNCE) {
+					_bounce_bullet(bullet, out_code);
+				} else {
+					//bullets outside the play area don't collide, and are popped once they can no longer come back
+					if (!_bullet_trajectory_valid(_area_positions[i], bullet->get_direction(), out_code)) {
+						bullet->state = Bullet::POPPED_OUT_OF_BOUNDS;
+						_pop_bullet(i);
+					}
+					continue;
+				}
+			}
+			_collision_queue.push_back(bullet);
+		}
+		_restore_heap();
+	}
+}
 
-	int clip_pos = _compute_out_code(play_area_rect, p_pos);
+void BulletServer::_emit_timed_volleys() {
+	//every live bullet keeps its timer, including ones outside the play area that are still coming back
+	for (int i = live_bullet_count - 1; i >= 0; i--) {
+		Bullet *bullet = bullet_pool[i];
+		const BulletTexture *texture = bullet->texture.ptr();
+		if (!bullet->is_popped() && texture && texture->emits_on_timer() && bullet->get_age() >= texture->get_emit_interval() * (bullet->emissions + 1)) {
+			bullet->emissions++;
+			_queue_child_spawn(bullet);
+		}
+	}
+}
 
-	if (clip_pos == 0) { return true; }
-	if (!play_area_allow_incoming) { return false; }
-	
-	int clip_dest = _compute_out_code(
-			play_area_rect, 
-			p_pos + MAX((play_area_rect.position + play_area_rect.size/2 - p_pos).length(), play_area_rect.size.length())*p_dir
-	);
+void BulletServer::_wrap_bullet(Bullet *p_bullet) {
+	Vector2 position = p_bullet->get_position() - play_area_rect.position;
+	if (play_area_rect.size.x > 0) {
+		position.x = Math::fposmod(position.x, play_area_rect.size.x);
+	}
+	if (play_area_rect.size.y > 0) {
+		position.y = Math::fposmod(position.y, play_area_rect.size.y);
+	}
+	p_bullet->set_position(play_area_rect.position + position);
+	//neither interpolation nor the collision sweep should stretch across the play area
+	p_bullet->previous_transform = p_bullet->transform;
+	p_bullet->motion = Vector2();
+}
 
-	if ((clip_pos & clip_dest) != 0) { return false; }
+void BulletServer::_bounce_bullet(Bullet *p_bullet, int p_out_code) {
+	Vector2 start = p_bullet->get_position() - p_bullet->motion;
+	Vector2 position = p_bullet->get_position();
+	Vector2 end = play_area_rect.get_end();
+	Vector2 flip = Vector2(1, 1);
+	if (p_out_code & OUTCODE_LEFT) {
+		position.x = 2.0 * play_area_rect.position.x - position.x;
+		flip.x = -1;
+	} else if (p_out_code & OUTCODE_RIGHT) {
+		position.x = 2.0 * end.x - position.x;
+		flip.x = -1;
+	}
+	if (p_out_code & OUTCODE_UP) {
+		position.y = 2.0 * play_area_rect.position.y - position.y;
+		flip.y = -1;
+	} else if (p_out_code & OUTCODE_DOWN) {
+		position.y = 2.0 * end.y - position.y;
+		flip.y = -1;
+	}
+	p_bullet->set_position(position.clamp(play_area_rect.position, end));
+	p_bullet->motion = p_bullet->get_position() - start;
+
+	//paths are shared, so they are mirrored by turning the bullet's heading onto the reflected direction
+	if (p_bullet->path->is_homing()) {
+		p_bullet->homing_velocity *= flip;
+	} else {
+		Vector2 direction = p_bullet->path->get_direction(p_bullet->get_age()).rotated(p_bullet->heading);
+		p_bullet->heading += (direction * flip).angle() - direction.angle();
+	}
+	p_bullet->impulse_velocity *= flip;
+	p_bullet->transform.set_rotation(p_bullet->get_rotation());
+}
 
-	return true;
+//homing bullets carry their direction in their own velocity, which is never zero so a bullet starting at rest keeps its aim
+static _FORCE_INLINE_ Vector2 _get_homing_velocity(const BulletPath *p_path, float p_time, float p_heading) {
+	return Vector2::from_angle(p_path->get_rotation(p_time) + p_heading) * MAX(p_path->get_speed(p_time), CMP_EPSILON);
 }
 
-void BulletServer::spawn_bullet(const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data) {
-	if (!_bullet_trajectory_valid(p_position, p_path->get_direction(0))) {
+void BulletServer::_spawn_bullet(const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data, float p_age, float p_heading, float p_speed) {
+	if (!deterministic && _governor_level >= GOVERNOR_REFUSE_SPAWNS && p_texture.is_valid() && p_texture->get_cosmetic()) {
+		return;
+	}
+
+	//wrapping and bouncing bring every bullet back into the play area, so only popping refuses spawns
+	if (play_area_mode != INFINITE && play_area_exit_mode == EXIT_POP && !_bullet_trajectory_valid(p_position, p_path->get_direction(0).rotated(p_heading), _compute_out_code(play_area_rect, p_position))) {
 		return;
 	}
 
+	//the oldest bullet is only found at the root of a valid heap
+	_restore_heap();
 	int index = 0;
 	if (live_bullet_count < bullet_pool_size) {
 		index = live_bullet_count;
 		live_bullet_count++;
+	} else {
+		MONITOR_COUNT(MONITOR_RECYCLED, 1);
 	}
+	MONITOR_COUNT(MONITOR_SPAWNED, 1);
 
 	Bullet* bullet = bullet_pool[index];
 
-	bullet->transform.set_rotation(p_path->get_rotation(0));//p_path->get_rotation(0));
+	bullet->transform.set_rotation(p_path->get_rotation(0) + p_heading);
 	bullet->transform.set_origin(p_position);
 	bullet->set_path(p_path);
-	bullet->set_texture(p_texture);
-	bullet->custom_data = p_custom_data;
-	bullet->spawntime = Time::get_singleton()->get_ticks_msec();
+	_set_bullet_type(bullet, p_texture);
+	//bullets of a volley share one entry, so the hint from the previous spawn usually skips the lookup
+	uint32_t data_id = _custom_data.acquire(p_custom_data, p_custom_data.is_empty() ? nullptr : p_custom_data.id(), _last_data_id);
+	_custom_data.release(bullet->data_id);
+	bullet->data_id = data_id;
+	_last_data_id = data_id;
+	const BulletTexture *texture = p_texture.ptr();
+	for (int s = 0; s < BulletTexture::PAYLOAD_SLOTS; s++) {
+		bullet->payload_ints[s * bullet->payload_stride] = texture ? texture->get_default_payload_int(s) : 0;
+		bullet->payload_floats[s * bullet->payload_stride] = texture ? texture->get_default_payload_float(s) : 0.0;
+	}
+	bullet->spawntime = _sim_clock;
+	bullet->serial = _spawn_serial++;
 	bullet->state = Bullet::LIVE;
-	RS::get_singleton()->canvas_item_set_visible(bullet->get_ci_rid(), true);
-	RS::get_singleton()->canvas_item_set_draw_index(bullet->get_ci_rid(), 0);
+	//a recycled bullet may still sit in this tick's cancel grid under its old position
+	_cancel_grid_dirty = true;
+	bullet->program = p_texture.is_valid() ? p_texture->get_program() : Ref<BulletProgram>();
+	if (bullet->program.is_valid() && !bullet->program->is_valid()) {
+		bullet->program.unref();
+	}
+	bullet->program_pc = 0;
+	bullet->program_wait = 0;
+	bullet->program_loop_pc = 0;
+	bullet->program_loop_left = 0;
+	bullet->program_ramp_ticks = 0;
+	bullet->program_speed = p_speed;
+	bullet->program_ramp = 0.0;
+	bullet->heading = p_heading;
+	bullet->emissions = 0;
+	bullet->impulse_velocity = Vector2();
+	bullet->impulse_force = Vector2();
+	if (p_path->is_homing()) {
+		bullet->homing_velocity = _get_homing_velocity(p_path.ptr(), 0.0, p_heading);
+		bullet->heading = 0.0;
+	}
+	if (p_age > 0.0) {
+		_advance_spawned_bullet(bullet, p_age);
+	}
+	//the next render sync shows the bullet if it's in view
+	bullet->previous_transform = bullet->transform;
+	bullet->motion = Vector2();
+	bullet->render_dirty = true;
 
-	_heapify(index);
+	_heap_update(index);
 }
 
-void BulletServer::spawn_volley(const Vector2 &p_origin, const Array &p_volley, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data) {
-	for (int i = 0; i < p_volley.size(); i++) {
-		Dictionary shot = p_volley[i];
-		spawn_bullet(p_origin + shot["position"], shot["path"], p_texture, p_custom_data);
+uint16_t BulletServer::_acquire_type(const Ref<BulletTexture> &p_texture, uint16_t p_hint) {
+	const BulletTexture *key = p_texture.ptr();
+	if (key == nullptr) {
+		return 0;
+	}
+	if (p_hint > 0 && _types[p_hint].texture.ptr() == key) {
+		_types[p_hint].users++;
+		return p_hint;
+	}
+	const uint16_t *existing = _type_ids.getptr(key);
+	if (existing) {
+		_types[*existing].users++;
+		return *existing;
 	}
-}
 
-void BulletServer::clear_bullets() {
-	for (int i = 0; i < live_bullet_count; i++) {
-		bullet_pool[i]->state = Bullet::POPPED_REQUESTED;
+	uint16_t id;
+	if (!_free_types.is_empty()) {
+		id = _free_types[_free_types.size() - 1];
+		_free_types.resize(_free_types.size() - 1);
+	} else {
+		//id 0 is reserved for "no texture"
+		if (_types.is_empty()) {
+			_types.resize(1);
+		}
+		ERR_FAIL_COND_V_MSG(_types.size() > UINT16_MAX, 0, "Too many distinct BulletTextures in use by one BulletServer.");
+		id = _types.size();
+		_types.resize(id + 1);
 	}
+	BulletType &type = _types[id];
+	type.texture = p_texture;
+	type.users = 1;
+	_type_ids.insert(key, id);
+	p_texture->connect_changed(callable_mp(this, &BulletServer::_refresh_type).bind(id));
+	_refresh_type(id);
+	return id;
 }
 
-Array BulletServer::get_live_bullets() {
-	Array bullets;
-	for (int i = 0; i < live_bullet_count; i++) {
-		bullets.push_back(bullet_pool[i]);
+void BulletServer::_release_type(uint16_t p_id) {
+	if (p_id == 0 || --_types[p_id].users > 0) {
+		return;
 	}
-	return bullets;
+	BulletType &type = _types[p_id];
+	type.texture->disconnect_changed(callable_mp(this, &BulletServer::_refresh_type).bind(p_id));
+	_type_ids.erase(type.texture.ptr());
+	if (type.atlas_sprite.is_valid()) {
+		_atlas.release(type.atlas_sprite);
+	}
+	if (type.atlas_effect_sprite.is_valid()) {
+		_atlas.release(type.atlas_effect_sprite);
+	}
+	type = BulletType();
+	_free_types.push_back(p_id);
 }
 
-int BulletServer::get_live_bullet_count() {
-	return live_bullet_count;
+void BulletServer::_refresh_type(uint32_t p_id) {
+	BulletType &type = _types[p_id];
+	const BulletTexture *texture = type.texture.ptr();
+	Ref<Shape2D> shape = texture->get_collision_shape();
+	Size2 extent = shape.is_valid() ? shape->get_rect().size : Size2();
+	type.shape_rid = shape.is_valid() ? shape->get_rid() : RID();
+	type.shape_reach = MIN(extent.x, extent.y);
+	type.collision_mask = texture->get_collision_mask();
+	type.collision_detect_bodies = texture->get_collision_detect_bodies();
+	type.collision_detect_areas = texture->get_collision_detect_areas();
+	type.cancel_layer = texture->get_cancel_layer();
+	type.cancel_mask = texture->get_cancel_mask();
+	type.cancel_radius = texture->get_cancel_radius();
+	type.modulate = texture->get_modulate();
+	type.draw_layer = texture->get_draw_layer();
+	Ref<Material> material = texture->get_material();
+	Size2 sheet = Size2(texture->get_animation_hframes(), texture->get_animation_vframes());
+	//the previous sprites are released only after the new ones are added, so an unchanged sprite is never repacked
+	Ref<Texture2D> old_sprite = type.atlas_sprite;
+	Ref<Texture2D> old_effect_sprite = type.atlas_effect_sprite;
+	type.atlas_sprite.unref();
+	type.atlas_effect_sprite.unref();
+	type.batch = -1;
+	if (render_mode == RENDER_MULTIMESH && texture->get_texture().is_valid()) {
+		type.batch = _get_sprite_batch(texture->get_texture(), sheet, texture->get_animation_start_frame(), type.draw_layer, material, texture->get_material_maps_atlas(), texture->get_light_mask(), type.atlas_sprite, type.uv, type.sprite_size);
+	}
+	type.effect_batch = -1;
+	type.effect_usec = texture->get_pop_effect_duration() * 1000000.0;
+	if (type.effect_usec > 0.0) {
+		//without a sheet of its own, the effect shows the bullet's sprite as it was when it popped
+		Ref<Texture2D> sprite = texture->get_pop_effect_texture();
+		type.effect_frames = 0;
+		if (sprite.is_valid()) {
+			sheet = Size2(texture->get_pop_effect_hframes(), texture->get_pop_effect_vframes());
+			type.effect_frames = sheet.x * sheet.y;
+		} else {
+			sprite = texture->get_texture();
+		}
+		if (sprite.is_valid()) {
+			type.effect_batch = _get_sprite_batch(sprite, sheet, 0, type.draw_layer, material, texture->get_material_maps_atlas(), texture->get_light_mask(), type.atlas_effect_sprite, type.effect_uv, type.effect_size);
+			type.effect_hframes = sheet.x;
+		}
+		type.effect_fade = texture->get_pop_effect_fade();
+		type.effect_scale = texture->get_pop_effect_scale();
+	}
+	type.frames = texture->get_animation_frame_count();
+	type.hframes = texture->get_animation_hframes();
+	type.fps = texture->get_animation_fps();
+	type.loop = texture->get_animation_loop();
+	type.start = texture->get_animation_start();
+	type.start_frame = texture->get_animation_start_frame();
+	if (old_sprite.is_valid()) {
+		_atlas.release(old_sprite);
+	}
+	if (old_effect_sprite.is_valid()) {
+		_atlas.release(old_effect_sprite);
+	}
+	type.revision++;
+	//canvas items keep whatever they were last drawn with, so live bullets are redrawn now and pooled ones when they next spawn
+	if (render_mode != RENDER_MULTIMESH && bullet_pool != nullptr) {
+		for (int i = 0; i < live_bullet_count; i++) {
+			Bullet *bullet = bullet_pool[i];
+			if (bullet->type_id != p_id) {
+				continue;
+			}
+			bullet->set_texture(type.texture);
+			RS::get_singleton()->canvas_item_set_draw_index(bullet->get_ci_rid(), type.draw_layer * DRAW_LAYER_STRIDE + p_id);
+			bullet->type_revision = type.revision;
+		}
+	}
 }
 
-Array BulletServer::get_live_bullet_positions() {
-	Array bullet_positions;
-	for (int i = 0; i < live_bullet_count; i++) {
-		bullet_positions.push_back(bullet_pool[i]->get_position());
+void BulletServer::_clear_types() {
+	for (uint32_t i = 1; i < _types.size(); i++) {
+		if (_types[i].texture.is_valid()) {
+			_types[i].texture->disconnect_changed(callable_mp(this, &BulletServer::_refresh_type).bind(i));
+		}
 	}
-	return bullet_positions;
+	_types.clear();
+	_type_ids.clear();
+	_free_types.clear();
 }
 
-void BulletServer::set_bullet_pool_size(int p_size) {
-	ERR_FAIL_COND_MSG(is_inside_tree() && !Engine::get_singleton()->is_editor_hint(), "Cannot resize bullet pool while server in in scene tree.");
-	if (p_size > -1)
-		bullet_pool_size = p_size;
+void BulletServer::_set_bullet_type(Bullet *p_bullet, const Ref<BulletTexture> &p_texture) {
+	uint16_t type_id = _acquire_type(p_texture, p_bullet->type_id);
+	_release_type(p_bullet->type_id);
+	//a slot respawned with the texture it last drew, unchanged since, needs no RenderingServer work at all
+	if (type_id == 0 || type_id != p_bullet->type_id || p_bullet->type_revision != _types[type_id].revision) {
+		if (render_mode == RENDER_MULTIMESH) {
+			//batched bullets are drawn from their type, so their own canvas items stay empty
+			p_bullet->texture = p_texture;
+		} else {
+			p_bullet->set_texture(p_texture);
+			//bullets of one type draw in one run, so the renderer can batch them, and overlap the same way every time
+			if (type_id != 0) {
+				RS::get_singleton()->canvas_item_set_draw_index(p_bullet->get_ci_rid(), _types[type_id].draw_layer * DRAW_LAYER_STRIDE + type_id);
+			}
+		}
+		p_bullet->type_revision = type_id ? _types[type_id].revision : 0;
+	}
+	p_bullet->type_id = type_id;
 }
 
-int BulletServer::get_bullet_pool_size() const {
-	return bullet_pool_size;
+bool BulletServer::_update_bullet_type(Bullet *p_bullet) {
+	if (p_bullet->type_id == 0 || _types[p_bullet->type_id].texture != p_bullet->texture) {
+		//the texture was swapped from script, so it has to be registered before its descriptor can be read
+		uint16_t type_id = _acquire_type(p_bullet->texture, 0);
+		_release_type(p_bullet->type_id);
+		p_bullet->type_id = type_id;
+	}
+	return p_bullet->type_id != 0;
 }
 
-void BulletServer::set_max_lifetime(float p_time) {
-	max_lifetime = p_time;
+int BulletServer::_get_animation_frame(const BulletType &p_type, const Bullet *p_bullet) const {
+	//derived from the spawn serial and the sim clock alone, so animations need no per-bullet state and replay exactly
+	uint32_t start = p_type.start_frame;
+	if (p_type.start == BulletTexture::ANIMATION_START_RANDOM) {
+		start = hash_murmur3_one_32(p_bullet->serial);
+	} else if (p_type.start == BulletTexture::ANIMATION_START_STAGGERED) {
+		start += p_bullet->serial;
+	}
+	start %= p_type.frames;
+	if (p_type.fps <= 0.0) {
+		return start;
+	}
+	uint64_t elapsed = (uint64_t)((_sim_clock - p_bullet->spawntime) * (double)p_type.fps / 1000000.0);
+	if (p_type.loop) {
+		return (start + elapsed) % p_type.frames;
+	}
+	return MIN(start + elapsed, (uint64_t)p_type.frames - 1);
 }
 
-float BulletServer::get_max_lifetime() const {
-	return max_lifetime;
-}
+int BulletServer::_get_sprite_batch(const Ref<Texture2D> &p_sprite, const Size2 &p_sheet, int p_frame, int p_layer, const Ref<Material> &p_material, bool p_maps_atlas, int p_light_mask, Ref<Texture2D> &r_atlas_sprite, Rect2 &r_uv, Size2 &r_size) {
+	RID material = p_material.is_valid() ? p_material->get_rid() : RID();
+	//materials only draw the right part of an atlas page if their shader maps UV onto the region each instance carries, which their texture has to declare
+	if (p_material.is_null() || p_maps_atlas) {
+		BulletAtlas::Region region;
+		if (!_atlas.add(p_sprite, region)) {
+			return -1;
+		}
+		r_atlas_sprite = p_sprite;
+		r_uv = Rect2(region.uv.position, region.uv.size / p_sheet);
+		r_size = region.size / p_sheet;
+		return _get_batch(p_layer, _atlas.get_page_rid(region.page), _get_batch_mesh(Rect2(0, 0, 1, 1)), material, p_light_mask, Ref<Texture2D>());
+	}
 
-void BulletServer::set_pop_on_collide(bool p_enabled) {
-	pop_on_collide = p_enabled;
+	//any other material draws the sprite's own texture, so it stays on one frame, like canvas item bullets
+	Vector2 cell = Vector2(1, 1) / p_sheet;
+	int hframes = p_sheet.x;
+	int frame = p_frame % int(p_sheet.x * p_sheet.y);
+	r_uv = Rect2(Vector2(), cell);
+	r_size = p_sprite->get_size() / p_sheet;
+	return _get_batch(p_layer, p_sprite->get_rid(), _get_batch_mesh(Rect2(Vector2(frame % hframes, frame / hframes) * cell, cell)), material, p_light_mask, p_sprite);
 }
 
-bool BulletServer::get_pop_on_collide() const {
-	return pop_on_collide;
-}
+RID BulletServer::_get_batch_mesh(const Rect2 &p_uv) {
+	bool unit = p_uv == Rect2(0, 0, 1, 1);
+	if (unit && _batch_mesh.is_valid()) {
+		return _batch_mesh;
+	}
+	const RID *existing = _batch_frame_meshes.getptr(p_uv);
+	if (existing) {
+		return *existing;
+	}
 
-void BulletServer::set_max_collisions_per_bullet(int p_count) {
-	max_collisions_per_bullet = p_count;
+	//a unit quad, scaled to each sprite by its instance transform
+	Vector2 uv_end = p_uv.get_end();
+	Array arrays;
+	arrays.resize(RS::ARRAY_MAX);
+	arrays[RS::ARRAY_VERTEX] = PackedVector2Array({ Vector2(-0.5, -0.5), Vector2(0.5, -0.5), Vector2(0.5, 0.5), Vector2(-0.5, 0.5) });
+	arrays[RS::ARRAY_TEX_UV] = PackedVector2Array({ p_uv.position, Vector2(uv_end.x, p_uv.position.y), uv_end, Vector2(p_uv.position.x, uv_end.y) });
+	arrays[RS::ARRAY_INDEX] = PackedInt32Array({ 0, 1, 2, 0, 2, 3 });
+	RID mesh = RS::get_singleton()->mesh_create();
+	RS::get_singleton()->mesh_add_surface_from_arrays(mesh, RS::PRIMITIVE_TRIANGLES, arrays);
+	if (unit) {
+		_batch_mesh = mesh;
+	} else {
+		_batch_frame_meshes.insert(p_uv, mesh);
+	}
+	return mesh;
 }
 
-int BulletServer::get_max_collisions_per_bullet() const {
-	return max_collisions_per_bullet;
-}
+int BulletServer::_get_batch(int p_layer, const RID &p_texture, const RID &p_mesh, const RID &p_material, int p_light_mask, const Ref<Texture2D> &p_sprite) {
+	for (uint32_t i = 0; i < _batches.size(); i++) {
+		const RenderBatch &batch = _batches[i];
+		if (batch.layer == p_layer && batch.texture == p_texture && batch.mesh == p_mesh && batch.material == p_material && batch.light_mask == p_light_mask) {
+			return i;
+		}
+	}
 
-void BulletServer::set_play_area_mode(AreaMode p_mode) {
-	play_area_mode = p_mode;
-	notify_property_list_changed();
-}
+	RenderingServer *rs = RS::get_singleton();
+	if (!_batch_material.is_valid()) {
+		//maps the quad onto the sprite's atlas region, which each instance carries as its custom data
+		_batch_shader = rs->shader_create();
+		rs->shader_set_code(_batch_shader, "shader_type canvas_item;\n\nvoid vertex() {\n\tUV = INSTANCE_CUSTOM.xy + UV * INSTANCE_CUSTOM.zw;\n}\n");
+		_batch_material = rs->material_create();
+		rs->material_set_shader(_batch_material, _batch_shader);
+	}
 
-BulletServer::AreaMode BulletServer::get_play_area_mode() const {
-	return play_area_mode;
+	RenderBatch batch;
+	batch.layer = p_layer;
+	batch.texture = p_texture;
+	batch.mesh = p_mesh;
+	batch.material = p_material;
+	batch.light_mask = p_light_mask;
+	batch.sprite = p_sprite;
+	batch.canvas_item = rs->canvas_item_create();
+	rs->canvas_item_set_parent(batch.canvas_item, _render_root);
+	rs->canvas_item_set_material(batch.canvas_item, p_material.is_valid() ? p_material : _batch_material);
+	rs->canvas_item_set_light_mask(batch.canvas_item, p_light_mask);
+	batch.multimesh = rs->multimesh_create();
+	rs->multimesh_set_mesh(batch.multimesh, p_mesh);
+	rs->canvas_item_add_multimesh(batch.canvas_item, batch.multimesh, p_texture);
+	_batches.push_back(batch);
+	_sort_batches();
+	return _batches.size() - 1;
 }
 
-void BulletServer::set_play_area_rect(const Rect2 &p_rect) {
-	play_area_rect = p_rect;
+void BulletServer::_sort_batches() {
+	//batches are drawn by layer, then material, then texture. there are few enough of them that counting
+	//the ones ahead of each is simpler than sorting
+	auto draws_before = [](const RenderBatch &p_a, const RenderBatch &p_b) {
+		if (p_a.layer != p_b.layer) {
+			return p_a.layer < p_b.layer;
+		}
+		if (p_a.material != p_b.material) {
+			return p_a.material < p_b.material;
+		}
+		if (p_a.texture != p_b.texture) {
+			return p_a.texture < p_b.texture;
+		}
+		if (p_a.mesh != p_b.mesh) {
+			return p_a.mesh < p_b.mesh;
+		}
+		return p_a.light_mask < p_b.light_mask;
+	};
+	for (uint32_t i = 0; i < _batches.size(); i++) {
+		const RenderBatch &batch = _batches[i];
+		int rank = 0;
+		for (uint32_t j = 0; j < _batches.size(); j++) {
+			if (draws_before(_batches[j], batch)) {
+				rank++;
+			}
+		}
+		RS::get_singleton()->canvas_item_set_draw_index(batch.canvas_item, batch.layer * DRAW_LAYER_STRIDE + rank);
+	}
 }
 
-Rect2 BulletServer::get_play_area_rect() const {
-	return play_area_rect;
+void BulletServer::_start_pop_effect(Bullet *p_bullet) {
+	//a full pool drops new effects rather than recycling live ones, so a mass clear costs no more than the pool
+	if (_effects.size() >= (uint32_t)render_effect_pool_size || !_update_bullet_type(p_bullet)) {
+		return;
+	}
+	uint16_t type_id = p_bullet->type_id;
+	if (_types[type_id].effect_batch < 0) {
+		return;
+	}
+	PopEffect effect;
+	effect.type_id = _acquire_type(p_bullet->texture, type_id);
+	effect.frame = _types[type_id].frames > 1 ? _get_animation_frame(_types[type_id], p_bullet) : 0;
+	effect.transform = p_bullet->transform;
+	effect.start = _sim_clock;
+	_effects.push_back(effect);
 }
 
-void BulletServer::set_play_area_margin(float p_margin) {
+//effects run out on the simulation clock, so they free their pool slots even while nothing draws them
+void BulletServer::_expire_pop_effects() {
+	for (uint32_t i = 0; i < _effects.size();) {
+		const BulletType &type = _types[_effects[i].type_id];
+		if (_sim_clock - _effects[i].start >= type.effect_usec || type.effect_batch < 0) {
+			_release_type(_effects[i].type_id);
+			_effects[i] = _effects[_effects.size() - 1];
+			_effects.resize(_effects.size() - 1);
+		} else {
+			i++;
+		}
+	}
+}
+
+void BulletServer::_free_batches() {
+	RenderingServer *rs = RS::get_singleton();
+	for (uint32_t i = 0; i < _batches.size(); i++) {
+		rs->free(_batches[i].canvas_item);
+		rs->free(_batches[i].multimesh);
+	}
+	_batches.clear();
+	_render_queue.clear();
+	_render_type_cursor.clear();
+	_render_effect_queue.clear();
+	if (_batch_material.is_valid()) {
+		rs->free(_batch_material);
+		rs->free(_batch_shader);
+		_batch_material = RID();
+		_batch_shader = RID();
+	}
+	if (_batch_mesh.is_valid()) {
+		rs->free(_batch_mesh);
+		_batch_mesh = RID();
+	}
+	for (const KeyValue<Rect2, RID> &E : _batch_frame_meshes) {
+		rs->free(E.value);
+	}
+	_batch_frame_meshes.clear();
+	_atlas.clear();
+}
+
+void BulletServer::_advance_spawned_bullet(Bullet *p_bullet, float p_age) {
+	//replays the fixed steps the bullet would have taken, so late volleys land where the sender's bullets are.
+	//the clock is unsigned, so a bullet older than the session wraps around; its age stays exact but it sorts as the newest when recycling
+	p_age = MIN(p_age, SPAWN_MAX_AGE);
+	uint64_t age_usec = (uint64_t)Math::round(p_age * 1000000.0);
+	p_bullet->spawntime = _sim_clock - age_usec;
+	p_bullet->path_start = _sim_clock - age_usec;
+
+	Ref<BulletPath> path = p_bullet->get_path();
+	//homing bullets fly unsteered until their first tick
+	float turn = path->is_homing() ? p_bullet->homing_velocity.angle() - path->get_rotation(0) : p_bullet->heading;
+	float step = MAX(1.0 / _get_ticks_per_second(), p_age / SPAWN_CATCH_UP_MAX_STEPS);
+	float time = 0.0;
+	Vector2 position = p_bullet->get_position();
+	while (time + step <= p_age) {
+		position += path->get_step(time, step).rotated(turn) * p_bullet->program_speed;
+		time += step;
+	}
+	if (p_age - time > CMP_EPSILON) {
+		position += path->get_step(time, p_age - time).rotated(turn) * p_bullet->program_speed;
+	}
+	p_bullet->set_position(position);
+	if (path->is_homing()) {
+		p_bullet->homing_velocity = _get_homing_velocity(path.ptr(), p_age, turn);
+	}
+}
+
+void BulletServer::_queue_child_spawn(const Bullet *p_bullet) {
+	ChildSpawn spawn;
+	spawn.texture = p_bullet->texture;
+	spawn.position = p_bullet->get_position();
+	spawn.rotation = p_bullet->texture->get_emit_relative() && p_bullet->path.is_valid() ? p_bullet->get_rotation() : 0.0;
+	spawn.custom_data = p_bullet->get_custom_data();
+	_child_spawns.push_back(spawn);
+}
+
+void BulletServer::_spawn_children() {
+	//children are spawned once per tick and can only pop from the next one, so chain reactions can't run away within a tick.
+	//they aren't recorded either, since replaying their parents spawns them again
+	for (uint32_t i = 0; i < _child_spawns.size(); i++) {
+		const ChildSpawn &spawn = _child_spawns[i];
+		const BulletTexture *texture = spawn.texture.ptr();
+		int count = texture->get_emit_count();
+		float width = texture->get_emit_arc_width();
+		float start = spawn.rotation + texture->get_emit_arc_rotation();
+		float spacing = 0.0;
+		if (count > 1 && width >= Math::TAU - CMP_EPSILON) {
+			spacing = Math::TAU / count;
+		} else if (count > 1) {
+			spacing = width / (count - 1);
+			start -= width / 2;
+		}
+		const Ref<BulletPath> &path = texture->get_emit_path();
+		const Ref<BulletTexture> &child_texture = texture->get_emit_texture();
+		for (int s = 0; s < count; s++) {
+			_spawn_bullet(spawn.position, path, child_texture, spawn.custom_data, 0.0, start + spacing * s);
+		}
+	}
+	_child_spawns.clear();
+}
+
+Vector2 BulletServer::_get_impulse_step(Bullet *p_bullet, float p_delta) {
+	if (p_bullet->impulse_force == Vector2()) {
+		return p_bullet->impulse_velocity * p_delta;
+	}
+	Vector2 step = (p_bullet->impulse_velocity + p_bullet->impulse_force * (p_delta / 2)) * p_delta;
+	p_bullet->impulse_velocity += p_bullet->impulse_force * p_delta;
+	return step;
+}
+
+Vector2 BulletServer::_get_bullet_step(Bullet *p_bullet, const Ref<BulletPath> &p_path, float p_delta) {
+	Vector2 step = p_path->get_step(p_bullet->get_path_time(), p_delta);
+	if (p_bullet->heading != 0.0) {
+		step = step.rotated(p_bullet->heading);
+	}
+	if (p_bullet->program_speed != 1.0) {
+		step *= p_bullet->program_speed;
+	}
+	if (p_bullet->_has_impulse()) {
+		step += _get_impulse_step(p_bullet, p_delta);
+	}
+	return step;
+}
+
+void BulletServer::_step_bullet_program(Bullet *p_bullet) {
+	if (p_bullet->path.is_null()) {
+		return;
+	}
+	if (p_bullet->program_ramp_ticks > 0) {
+		p_bullet->program_speed += p_bullet->program_ramp;
+		p_bullet->program_ramp_ticks--;
+	}
+	if (p_bullet->program_wait > 0) {
+		p_bullet->program_wait--;
+		if (p_bullet->program_wait > 0) {
+			return;
+		}
+	}
+
+	const BulletProgram *program = p_bullet->program.ptr();
+	const LocalVector<BulletProgram::Instruction> &code = program->get_code();
+	bool heading_changed = false;
+
+	for (int executed = 0; executed < BulletProgram::MAX_INSTRUCTIONS_PER_TICK; executed++) {
+		if (p_bullet->program_pc >= code.size()) {
+			break;
+		}
+		const BulletProgram::Instruction &instruction = code[p_bullet->program_pc];
+		p_bullet->program_pc++;
+
+		switch (instruction.op) {
+			case BulletProgram::OP_WAIT: {
+				p_bullet->program_wait = instruction.i;
+			} break;
+			case BulletProgram::OP_SPEED: {
+				p_bullet->program_speed = instruction.f;
+				p_bullet->program_ramp_ticks = 0;
+			} break;
+			case BulletProgram::OP_RAMP: {
+				if (instruction.i == 0) {
+					p_bullet->program_speed = instruction.f;
+					p_bullet->program_ramp_ticks = 0;
+				} else {
+					p_bullet->program_ramp = (instruction.f - p_bullet->program_speed) / instruction.i;
+					p_bullet->program_ramp_ticks = instruction.i;
+				}
+			} break;
+			case BulletProgram::OP_TURN: {
+				p_bullet->heading += instruction.f;
+				heading_changed = true;
+			} break;
+			case BulletProgram::OP_AIM: {
+				Vector2 target;
+				if (_get_nearest_target(program->get_target_group(), p_bullet->get_position(), target)) {
+					p_bullet->heading += Math::angle_difference(p_bullet->get_rotation(), (target - p_bullet->get_position()).angle());
+					heading_changed = true;
+				}
+			} break;
+			case BulletProgram::OP_PATH: {
+				const Ref<BulletPath> &new_path = program->get_path_ref(instruction.i);
+				ERR_CONTINUE(new_path.is_null());
+				//the shared path is turned to the current direction of travel through the heading, so switching allocates nothing
+				float angle = p_bullet->get_rotation();
+				p_bullet->set_path(new_path);
+				p_bullet->heading = angle - new_path->get_rotation(0);
+				if (new_path->is_homing()) {
+					p_bullet->homing_velocity = _get_homing_velocity(new_path.ptr(), 0.0, p_bullet->heading);
+					p_bullet->heading = 0.0;
+				}
+				heading_changed = true;
+			} break;
+			case BulletProgram::OP_REPEAT: {
+				p_bullet->program_loop_pc = p_bullet->program_pc;
+				p_bullet->program_loop_left = instruction.i;
+			} break;
+			case BulletProgram::OP_END: {
+				if (p_bullet->program_loop_left == 0 || --p_bullet->program_loop_left > 0) {
+					p_bullet->program_pc = p_bullet->program_loop_pc;
+				}
+			} break;
+			case BulletProgram::OP_POP: {
+				p_bullet->state = Bullet::POPPED_REQUESTED;
+				p_bullet->program_wait = 1;
+			} break;
+		}
+		if (p_bullet->program_wait > 0) {
+			break;
+		}
+	}
+
+	if (p_bullet->program_wait == 0 && p_bullet->program_pc < code.size()) {
+		ERR_PRINT_ONCE(vformat("BulletProgram ran %d instructions in one tick without waiting and was stopped. Add a 'wait' inside endless loops.", BulletProgram::MAX_INSTRUCTIONS_PER_TICK));
+		p_bullet->program_pc = code.size();
+	}
+	if (heading_changed) {
+		p_bullet->transform.set_rotation(p_bullet->get_rotation());
+		p_bullet->render_dirty = true;
+	}
+}
+
+const LocalVector<Vector2> &BulletServer::_get_target_positions(const StringName &p_group) {
+	//positions are looked up once per group per tick, however many bullets ask for them
+	if (_target_positions_tick != _tick_count) {
+		_target_positions.clear();
+		_target_node_positions.clear();
+		_target_positions_tick = _tick_count;
+	}
+	LocalVector<Vector2> *cached = _target_positions.getptr(p_group);
+	if (cached) {
+		return *cached;
+	}
+
+	LocalVector<Vector2> &positions = _target_positions[p_group];
+	if (p_group != StringName()) {
+		List<Node *> nodes;
+		get_tree()->get_nodes_in_group(p_group, &nodes);
+		for (Node *node : nodes) {
+			Node2D *node_2d = Object::cast_to<Node2D>(node);
+			if (node_2d) {
+				positions.push_back(node_2d->get_global_position());
+			}
+		}
+	}
+	return positions;
+}
+
+bool BulletServer::_get_target_node_position(ObjectID p_node, Vector2 &r_position) {
+	if (_target_positions_tick != _tick_count) {
+		_target_positions.clear();
+		_target_node_positions.clear();
+		_target_positions_tick = _tick_count;
+	}
+	const Vector2 *cached = _target_node_positions.getptr(p_node);
+	if (cached) {
+		r_position = *cached;
+		return true;
+	}
+	Node2D *node = Object::cast_to<Node2D>(ObjectDB::get_instance(p_node));
+	if (!node || !node->is_inside_tree()) {
+		return false;
+	}
+	r_position = node->get_global_position();
+	_target_node_positions.insert(p_node, r_position);
+	return true;
+}
+
+bool BulletServer::_get_nearest_target(const StringName &p_group, const Vector2 &p_from, Vector2 &r_target) {
+	const LocalVector<Vector2> &targets = _get_target_positions(p_group);
+	float nearest = INFINITY;
+	for (uint32_t i = 0; i < targets.size(); i++) {
+		float distance = p_from.distance_squared_to(targets[i]);
+		if (distance < nearest) {
+			nearest = distance;
+			r_target = targets[i];
+		}
+	}
+	return nearest != INFINITY;
+}
+
+void BulletServer::_steer_homing_bullets(float delta) {
+	uint64_t trace_start = BulletTracer::get_singleton()->begin_span();
+	for (uint32_t i = 0; i < _homing_queue.size(); i++) {
+		Bullet *bullet = _homing_queue[i];
+		//only homing paths are queued here
+		const HomingBulletPath *path = static_cast<const HomingBulletPath *>(bullet->path.ptr());
+		Vector2 position = bullet->get_position();
+
+		//turns made by a program are folded into the velocity
+		float angle = bullet->homing_velocity.angle() + bullet->heading;
+		bullet->heading = 0.0;
+		float speed = CLAMP(bullet->homing_velocity.length() + path->get_acceleration() * delta, 0.0f, path->get_max_speed());
+
+		if (bullet->get_path_time() >= path->get_homing_delay()) {
+			Vector2 target;
+			bool found = path->get_target_node_id().is_valid() && _get_target_node_position(path->get_target_node_id(), target);
+			if (found || _get_nearest_target(path->get_target_group(), position, target)) {
+				float max_turn = path->get_turn_rate() * delta;
+				angle += CLAMP(Math::angle_difference(angle, (target - position).angle()), -max_turn, max_turn);
+			}
+		}
+
+		Vector2 direction = Vector2::from_angle(angle);
+		bullet->homing_velocity = direction * MAX(speed, CMP_EPSILON);
+		Vector2 step = direction * speed * bullet->program_speed * delta;
+		if (bullet->_has_impulse()) {
+			step += _get_impulse_step(bullet, delta);
+		}
+		bullet->motion = step;
+		bullet->set_position(position + step);
+		bullet->transform.set_rotation(angle);
+	}
+	BulletTracer::get_singleton()->end_span("steer_homing", this, trace_start, _homing_queue.size());
+}
+
+void BulletServer::spawn_bullet(const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data) {
+	uint64_t trace_start = BulletTracer::get_singleton()->begin_span();
+	if (_record_log.is_writing()) {
+		_record_log.write_bullet(_tick_count - _record_start_tick, p_position, p_path, p_texture, p_custom_data);
+	}
+	_spawn_bullet(p_position, p_path, p_texture, p_custom_data);
+	BulletTracer::get_singleton()->end_span("spawn_bullet", this, trace_start, 1);
+}
+
+void BulletServer::spawn_volley(const Vector2 &p_origin, const Array &p_volley, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data) {
+	uint64_t trace_start = BulletTracer::get_singleton()->begin_span();
+	if (_record_log.is_writing()) {
+		_record_log.write_volley(_tick_count - _record_start_tick, p_origin, p_volley, p_texture, p_custom_data);
+	}
+	for (int i = 0; i < p_volley.size(); i++) {
+		Dictionary shot = p_volley[i];
+		_spawn_bullet(p_origin + shot["position"], shot["path"], p_texture, p_custom_data, shot.get("age", 0.0), 0.0, shot.get("speed", 1.0));
+	}
+	BulletTracer::get_singleton()->end_span("spawn_volley", this, trace_start, p_volley.size());
+}
+
+void BulletServer::_schedule_spawn(uint64_t p_due, const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data) {
+	uint32_t index;
+	if (_scheduled_free.is_empty()) {
+		index = _scheduled.size();
+		_scheduled.push_back(ScheduledSpawn());
+	} else {
+		index = _scheduled_free[_scheduled_free.size() - 1];
+		_scheduled_free.resize(_scheduled_free.size() - 1);
+	}
+	ScheduledSpawn &spawn = _scheduled[index];
+	spawn.due = p_due;
+	spawn.position = p_position;
+	spawn.path = p_path;
+	spawn.texture = p_texture;
+	spawn.custom_data = p_custom_data;
+	_wheel_insert(index);
+}
+
+void BulletServer::_wheel_insert(uint32_t p_index) {
+	//a spawn belongs to the first tick that ends at or after its due time; overdue ones go in the next tick to expire
+	uint64_t due_tick = (_scheduled[p_index].due + _wheel_tick_usec - 1) / _wheel_tick_usec;
+	if (due_tick < _wheel_tick) {
+		due_tick = _wheel_tick;
+	}
+	uint64_t ticks_left = due_tick - _wheel_tick;
+	for (int level = 0; level < WHEEL_LEVELS; level++) {
+		if (ticks_left < (uint64_t(1) << (WHEEL_BITS * (level + 1)))) {
+			_wheel[level][(due_tick >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1)].push_back(p_index);
+			return;
+		}
+	}
+	_wheel_overflow.push_back(p_index);
+}
+
+void BulletServer::_wheel_cascade(int p_level) {
+	LocalVector<uint32_t> entries;
+	if (p_level < WHEEL_LEVELS) {
+		SWAP(entries, _wheel[p_level][(_wheel_tick >> (WHEEL_BITS * p_level)) & (WHEEL_SIZE - 1)]);
+	} else {
+		SWAP(entries, _wheel_overflow);
+	}
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		_wheel_insert(entries[i]);
+	}
+}
+
+void BulletServer::_expire_scheduled_spawns() {
+	uint64_t now_tick = _sim_clock / _wheel_tick_usec;
+	if (_scheduled_free.size() == _scheduled.size()) {
+		_wheel_tick = now_tick + 1;
+		return;
+	}
+	uint64_t trace_start = BulletTracer::get_singleton()->begin_span();
+	int spawned = 0;
+	while (_wheel_tick <= now_tick) {
+		//higher levels are cascaded first, so what they hand down lands in slots that haven't been visited yet
+		if ((_wheel_tick & (WHEEL_SIZE - 1)) == 0) {
+			int level = 1;
+			while (level < WHEEL_LEVELS && ((_wheel_tick >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1)) == 0) {
+				level++;
+			}
+			for (; level > 0; level--) {
+				_wheel_cascade(level);
+			}
+		}
+
+		LocalVector<uint32_t> &slot = _wheel[0][_wheel_tick & (WHEEL_SIZE - 1)];
+		for (uint32_t i = 0; i < slot.size(); i++) {
+			ScheduledSpawn &spawn = _scheduled[slot[i]];
+			//the first step makes up exactly the time the spawn was due before the end of this tick
+			float age = (_sim_clock - spawn.due) / 1000000.0;
+			if (_record_log.is_writing()) {
+				_record_log.write_bullet(_tick_count - _record_start_tick, spawn.position, spawn.path, spawn.texture, spawn.custom_data, age);
+			}
+			_spawn_bullet(spawn.position, spawn.path, spawn.texture, spawn.custom_data, age);
+			spawn.path.unref();
+			spawn.texture.unref();
+			spawn.custom_data = Dictionary();
+			_scheduled_free.push_back(slot[i]);
+			spawned++;
+		}
+		slot.clear();
+		_wheel_tick++;
+	}
+	BulletTracer::get_singleton()->end_span("scheduled_spawns", this, trace_start, spawned);
+}
+
+void BulletServer::_get_scheduled_entries(LocalVector<uint32_t> &r_entries) const {
+	for (int level = 0; level < WHEEL_LEVELS; level++) {
+		for (int slot = 0; slot < WHEEL_SIZE; slot++) {
+			for (uint32_t i = 0; i < _wheel[level][slot].size(); i++) {
+				r_entries.push_back(_wheel[level][slot][i]);
+			}
+		}
+	}
+	for (uint32_t i = 0; i < _wheel_overflow.size(); i++) {
+		r_entries.push_back(_wheel_overflow[i]);
+	}
+}
+
+void BulletServer::_rebuild_schedule() {
+	//after the clock jumps, pending spawns are sorted into the wheel again from the new time
+	LocalVector<uint32_t> entries;
+	_get_scheduled_entries(entries);
+	for (int level = 0; level < WHEEL_LEVELS; level++) {
+		for (int slot = 0; slot < WHEEL_SIZE; slot++) {
+			_wheel[level][slot].clear();
+		}
+	}
+	_wheel_overflow.clear();
+	_wheel_tick = _sim_clock / _wheel_tick_usec + 1;
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		_wheel_insert(entries[i]);
+	}
+}
+
+void BulletServer::schedule_spawn(float p_delay, const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data) {
+	ERR_FAIL_COND_MSG(p_path.is_null(), "Cannot schedule a bullet without a path.");
+	_schedule_spawn(_sim_clock + (uint64_t)Math::round(MAX(p_delay, 0.0) * 1000000.0), p_position, p_path, p_texture, p_custom_data);
+}
+
+void BulletServer::schedule_volley(float p_delay, const Vector2 &p_origin, const Array &p_volley, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data) {
+	for (int i = 0; i < p_volley.size(); i++) {
+		Dictionary shot = p_volley[i];
+		Ref<BulletPath> path = shot["path"];
+		ERR_CONTINUE_MSG(path.is_null(), "Cannot schedule a shot without a path.");
+		float delay = MAX(p_delay + float(shot.get("delay", 0.0)), 0.0);
+		_schedule_spawn(_sim_clock + (uint64_t)Math::round(delay * 1000000.0), p_origin + Vector2(shot["position"]), path, p_texture, p_custom_data);
+	}
+}
+
+int BulletServer::get_scheduled_spawn_count() const {
+	return _scheduled.size() - _scheduled_free.size();
+}
+
+void BulletServer::clear_scheduled_spawns() {
+	for (int level = 0; level < WHEEL_LEVELS; level++) {
+		for (int slot = 0; slot < WHEEL_SIZE; slot++) {
+			_wheel[level][slot].clear();
+		}
+	}
+	_wheel_overflow.clear();
+	_scheduled.clear();
+	_scheduled_free.clear();
+}
+
+void BulletServer::_run_patterns() {
+	uint64_t trace_start = BulletTracer::get_singleton()->begin_span();
+	int run_count = _patterns.size();
+	for (uint32_t i = 0; i < _patterns.size(); i++) {
+		if (!_step_pattern(_patterns[i])) {
+			//finished runners are swapped out; the one moved in has not run yet this tick
+			_patterns[i] = _patterns[_patterns.size() - 1];
+			_patterns.resize(_patterns.size() - 1);
+			i--;
+		}
+	}
+	//sub-patterns start on the tick after the instruction that started them
+	for (uint32_t i = 0; i < _started_patterns.size(); i++) {
+		_patterns.push_back(_started_patterns[i]);
+	}
+	_started_patterns.clear();
+	BulletTracer::get_singleton()->end_span("run_patterns", this, trace_start, run_count);
+}
+
+bool BulletServer::_step_pattern(PatternRunner &r_runner) {
+	if (r_runner.wait > 0) {
+		r_runner.wait--;
+		if (r_runner.wait > 0) {
+			return true;
+		}
+	}
+	const LocalVector<BulletPattern::Instruction> &code = r_runner.pattern->get_code();
+
+	for (int executed = 0; executed < BulletPattern::MAX_INSTRUCTIONS_PER_TICK; executed++) {
+		if (r_runner.pc >= code.size()) {
+			return false;
+		}
+		const BulletPattern::Instruction &instruction = code[r_runner.pc];
+		r_runner.pc++;
+
+		switch (instruction.op) {
+			case BulletPattern::OP_FIRE: {
+				_fire_pattern(r_runner);
+			} break;
+			case BulletPattern::OP_WAIT: {
+				if (instruction.i > 0) {
+					r_runner.wait = instruction.i;
+					return true;
+				}
+			} break;
+			case BulletPattern::OP_REPEAT: {
+				r_runner.loops.push_back(Vector2i(r_runner.pc, instruction.i));
+			} break;
+			case BulletPattern::OP_END: {
+				if (r_runner.loops.is_empty()) {
+					return false;
+				}
+				Vector2i &loop = r_runner.loops[r_runner.loops.size() - 1];
+				if (loop.y == 0 || --loop.y > 0) {
+					r_runner.pc = loop.x;
+				} else {
+					r_runner.loops.resize(r_runner.loops.size() - 1);
+				}
+			} break;
+			case BulletPattern::OP_DIRECTION: {
+				r_runner.direction = instruction.f;
+			} break;
+			case BulletPattern::OP_TURN: {
+				r_runner.direction += instruction.f;
+			} break;
+			case BulletPattern::OP_AIM: {
+				r_runner.direction = (r_runner.target - r_runner.origin).angle() - r_runner.rotation;
+			} break;
+			case BulletPattern::OP_SPEED: {
+				r_runner.speed = instruction.f;
+			} break;
+			case BulletPattern::OP_ACCEL: {
+				r_runner.speed += instruction.f;
+			} break;
+			case BulletPattern::OP_SHOTS: {
+				r_runner.shots = instruction.i;
+			} break;
+			case BulletPattern::OP_ARC: {
+				r_runner.arc = instruction.f;
+			} break;
+			case BulletPattern::OP_RADIUS: {
+				r_runner.radius = instruction.f;
+			} break;
+			case BulletPattern::OP_SUB: {
+				Array sub_patterns = r_runner.pattern->get_sub_patterns();
+				ERR_CONTINUE_MSG(instruction.i >= sub_patterns.size(), vformat("BulletPattern has no sub-pattern %d.", instruction.i));
+				Ref<BulletPattern> sub_pattern = sub_patterns[instruction.i];
+				ERR_CONTINUE(sub_pattern.is_null() || !sub_pattern->is_valid());
+				PatternRunner sub_runner;
+				sub_runner.pattern = sub_pattern;
+				sub_runner.id = _next_pattern_id++;
+				sub_runner.origin = r_runner.origin;
+				sub_runner.rotation = r_runner.rotation + r_runner.direction;
+				sub_runner.target = r_runner.target;
+				_started_patterns.push_back(sub_runner);
+			} break;
+		}
+	}
+	ERR_FAIL_V_MSG(false, vformat("BulletPattern ran %d instructions in one tick without waiting and was stopped. Add a 'wait' inside endless loops.", BulletPattern::MAX_INSTRUCTIONS_PER_TICK));
+}
+
+void BulletServer::_fire_pattern(const PatternRunner &p_runner) {
+	Ref<BulletPath> path = p_runner.pattern->get_bullet_path();
+	Ref<BulletTexture> texture = p_runner.pattern->get_bullet_texture();
+	ERR_FAIL_COND_MSG(path.is_null() || texture.is_null(), "BulletPattern needs a bullet_path and bullet_texture to fire.");
+	Dictionary custom_data = p_runner.pattern->get_custom_data();
+
+	float spacing = 0.0;
+	float first = p_runner.rotation + p_runner.direction;
+	if (p_runner.shots > 1 && p_runner.arc >= Math::TAU - CMP_EPSILON) {
+		spacing = Math::TAU / p_runner.shots;
+	} else if (p_runner.shots > 1) {
+		spacing = p_runner.arc / (p_runner.shots - 1);
+		first -= p_runner.arc / 2;
+	}
+
+	for (int i = 0; i < p_runner.shots; i++) {
+		float angle = first + spacing * i;
+		Vector2 position = p_runner.origin + Vector2(p_runner.radius, 0).rotated(angle);
+		//shots share the pattern's path and are turned and sped up per bullet, so firing allocates nothing
+		if (_record_log.is_writing()) {
+			_record_log.write_bullet(_tick_count - _record_start_tick, position, path, texture, custom_data, 0.0, angle, p_runner.speed);
+		}
+		_spawn_bullet(position, path, texture, custom_data, 0.0, angle, p_runner.speed);
+	}
+}
+
+BulletServer::PatternRunner *BulletServer::_get_pattern_runner(int p_id) {
+	for (uint32_t i = 0; i < _patterns.size(); i++) {
+		if (_patterns[i].id == p_id) {
+			return &_patterns[i];
+		}
+	}
+	for (uint32_t i = 0; i < _started_patterns.size(); i++) {
+		if (_started_patterns[i].id == p_id) {
+			return &_started_patterns[i];
+		}
+	}
+	return nullptr;
+}
+
+int BulletServer::run_pattern(const Ref<BulletPattern> &p_pattern, const Vector2 &p_origin, float p_rotation, const Vector2 &p_target) {
+	ERR_FAIL_COND_V(p_pattern.is_null(), -1);
+	ERR_FAIL_COND_V_MSG(!p_pattern->is_valid(), -1, "BulletPattern failed to compile and can't be run.");
+	PatternRunner runner;
+	runner.pattern = p_pattern;
+	runner.id = _next_pattern_id++;
+	runner.origin = p_origin;
+	runner.rotation = p_rotation;
+	runner.target = p_target;
+	_patterns.push_back(runner);
+	return runner.id;
+}
+
+void BulletServer::stop_pattern(int p_id) {
+	PatternRunner *runner = _get_pattern_runner(p_id);
+	if (runner) {
+		//jumping past the end lets the runner be removed on its next step
+		runner->pc = runner->pattern->get_code().size();
+		runner->wait = 0;
+	}
+}
+
+void BulletServer::stop_all_patterns() {
+	_patterns.clear();
+	_started_patterns.clear();
+}
+
+bool BulletServer::is_pattern_running(int p_id) const {
+	return const_cast<BulletServer *>(this)->_get_pattern_runner(p_id) != nullptr;
+}
+
+void BulletServer::set_pattern_origin(int p_id, const Vector2 &p_origin, float p_rotation) {
+	PatternRunner *runner = _get_pattern_runner(p_id);
+	ERR_FAIL_NULL_MSG(runner, vformat("No pattern with id %d is running.", p_id));
+	runner->origin = p_origin;
+	runner->rotation = p_rotation;
+}
+
+void BulletServer::set_pattern_target(int p_id, const Vector2 &p_target) {
+	PatternRunner *runner = _get_pattern_runner(p_id);
+	ERR_FAIL_NULL_MSG(runner, vformat("No pattern with id %d is running.", p_id));
+	runner->target = p_target;
+}
+
+void BulletServer::_replay_spawns() {
+	//volleys logged at a tick were spawned after that many ticks had been processed, so they go in before the next one
+	uint64_t tick = _tick_count - _replay_start_tick;
+	while (_replay_pending && _replay_volley.tick <= tick) {
+		if (_replay_volley.texture.is_valid()) {
+			spawn_volley(_replay_volley.origin, _replay_volley.shots, _replay_volley.texture, _replay_volley.custom_data);
+		}
+		_replay_pending = _replay_log.read_volley(_replay_volley);
+	}
+}
+
+Error BulletServer::start_recording(const String &p_path) {
+	Error err = _record_log.open_write(p_path, _get_ticks_per_second());
+	_record_start_tick = _tick_count;
+	return err;
+}
+
+void BulletServer::stop_recording() {
+	_record_log.close();
+}
+
+bool BulletServer::is_recording() const {
+	return _record_log.is_writing();
+}
+
+Error BulletServer::start_replay(const String &p_path) {
+	Error err = _replay_log.open_read(p_path);
+	ERR_FAIL_COND_V(err != OK, err);
+	if (_replay_log.get_ticks_per_second() != (uint32_t)_get_ticks_per_second()) {
+		WARN_PRINT(vformat("Spawn log '%s' was recorded at %d ticks per second, but this server runs at %d. Use replay_ticks() to replay it at its own rate.", p_path, _replay_log.get_ticks_per_second(), _get_ticks_per_second()));
+	}
+	_replay_start_tick = _tick_count;
+	_replay_pending = _replay_log.read_volley(_replay_volley);
+	return OK;
+}
+
+int BulletServer::replay_ticks(int p_ticks) {
+	ERR_FAIL_COND_V_MSG(!_replay_log.is_open(), 0, "No spawn log is being replayed. Call start_replay() first.");
+	ERR_FAIL_COND_V(!is_inside_tree(), 0);
+	uint32_t ticks_per_second = _replay_log.get_ticks_per_second();
+	float delta = 1.0 / (ticks_per_second > 0 ? ticks_per_second : _get_ticks_per_second());
+
+	int played = 0;
+	while (p_ticks < 0 ? _replay_pending : played < p_ticks) {
+		_replay_spawns();
+		_process_bullets(delta);
+		played++;
+	}
+	return played;
+}
+
+void BulletServer::stop_replay() {
+	_replay_log.close();
+	_replay_pending = false;
+	_replay_volley = BulletSpawnLog::Volley();
+}
+
+bool BulletServer::is_replaying() const {
+	return _replay_log.is_open();
+}
+
+void BulletServer::clear_bullets() {
+	for (int i = 0; i < live_bullet_count; i++) {
+		bullet_pool[i]->state = Bullet::POPPED_REQUESTED;
+	}
+}
+
+double BulletServer::get_sim_time() const {
+	return _sim_clock / 1000000.0;
+}
+
+PackedByteArray BulletServer::save_state() {
+	ERR_FAIL_NULL_V_MSG(bullet_pool, PackedByteArray(), "Cannot save state of a BulletServer that is not in the scene tree.");
+
+	//ids only stay valid for the retention period, which is how far back a snapshot can be loaded
+	if (state_retention_ticks > 0 && _tick_count >= _state_pruned_tick + state_retention_ticks) {
+		_state_pruned_tick = _tick_count;
+		uint64_t unused_since = _tick_count - state_retention_ticks;
+		_state_paths.prune(unused_since);
+		_state_textures.prune(unused_since);
+		_state_data.prune(unused_since);
+		_state_patterns.prune(unused_since);
+	}
+
+	//pending spawns go after the bullets, so the bullets keep their offsets in deltas as spawns come and go
+	LocalVector<uint32_t> scheduled;
+	_get_scheduled_entries(scheduled);
+
+	//pattern runners go last. started ones haven't joined the rest yet, and must still wait a tick once restored
+	uint32_t pattern_count = _patterns.size() + _started_patterns.size();
+	uint32_t pattern_size = 0;
+	for (uint32_t i = 0; i < pattern_count; i++) {
+		const PatternRunner &runner = i < _patterns.size() ? _patterns[i] : _started_patterns[i - _patterns.size()];
+		pattern_size += STATE_PATTERN_SIZE + runner.loops.size() * 8;
+	}
+
+	PackedByteArray state;
+	state.resize(STATE_HEADER_SIZE + live_bullet_count * STATE_BULLET_SIZE + scheduled.size() * STATE_SCHEDULED_SIZE + pattern_size);
+	uint8_t *w = state.ptrw();
+
+	w += encode_uint32(STATE_MAGIC, w);
+	w += encode_uint32(STATE_VERSION, w);
+	w += encode_uint32(live_bullet_count, w);
+	w += encode_uint32(_spawn_serial, w);
+	w += encode_uint64(_sim_clock, w);
+	w += encode_uint64(_tick_count, w);
+	w += encode_uint32(scheduled.size(), w);
+	w += encode_uint32(pattern_count, w);
+	w += encode_uint32(_next_pattern_id, w);
+
+	for (int i = 0; i < live_bullet_count; i++) {
+		Bullet *bullet = bullet_pool[i];
+
+		bullet->path_state_id = _state_paths.intern(bullet->path, bullet->path.ptr(), _tick_count, bullet->path_state_id);
+		bullet->texture_state_id = _state_textures.intern(bullet->texture, bullet->texture.ptr(), _tick_count, bullet->texture_state_id);
+		if (bullet->data_id) {
+			const Dictionary &data = _custom_data.get(bullet->data_id);
+			bullet->data_state_id = _state_data.intern(data, data.id(), _tick_count, bullet->data_state_id);
+		} else {
+			bullet->data_state_id = 0;
+		}
+		ERR_FAIL_COND_V_MSG(bullet->texture_state_id > UINT16_MAX, PackedByteArray(), "Too many distinct BulletTextures to save state.");
+
+		const Transform2D &xform = bullet->transform;
+		w += encode_float(xform.columns[0].x, w);
+		w += encode_float(xform.columns[0].y, w);
+		w += encode_float(xform.columns[1].x, w);
+		w += encode_float(xform.columns[1].y, w);
+		w += encode_float(xform.columns[2].x, w);
+		w += encode_float(xform.columns[2].y, w);
+		w += encode_uint64(bullet->spawntime, w);
+		w += encode_uint64(bullet->path_start, w);
+		w += encode_uint32(bullet->serial, w);
+		w += encode_uint32(bullet->path_state_id, w);
+		w += encode_uint16(bullet->texture_state_id, w);
+		w += encode_uint32(bullet->data_state_id, w);
+		*w++ = bullet->state;
+		w += encode_uint16(bullet->program_pc, w);
+		w += encode_uint16(bullet->program_wait, w);
+		w += encode_uint16(bullet->program_loop_pc, w);
+		w += encode_uint16(bullet->program_loop_left, w);
+		w += encode_uint16(bullet->program_ramp_ticks, w);
+		w += encode_float(bullet->program_speed, w);
+		w += encode_float(bullet->program_ramp, w);
+		w += encode_float(bullet->heading, w);
+		w += encode_uint32(bullet->emissions, w);
+		w += encode_float(bullet->homing_velocity.x, w);
+		w += encode_float(bullet->homing_velocity.y, w);
+		w += encode_float(bullet->impulse_velocity.x, w);
+		w += encode_float(bullet->impulse_velocity.y, w);
+		w += encode_float(bullet->impulse_force.x, w);
+		w += encode_float(bullet->impulse_force.y, w);
+		for (int s = 0; s < BulletTexture::PAYLOAD_SLOTS; s++) {
+			w += encode_uint32(bullet->payload_ints[s * bullet->payload_stride], w);
+		}
+		for (int s = 0; s < BulletTexture::PAYLOAD_SLOTS; s++) {
+			w += encode_float(bullet->payload_floats[s * bullet->payload_stride], w);
+		}
+		w += encode_uint32(_state_paths.get_generation(bullet->path_state_id), w);
+		w += encode_uint32(_state_textures.get_generation(bullet->texture_state_id), w);
+		w += encode_uint32(_state_data.get_generation(bullet->data_state_id), w);
+	}
+
+	for (uint32_t i = 0; i < scheduled.size(); i++) {
+		const ScheduledSpawn &spawn = _scheduled[scheduled[i]];
+		uint32_t path_id = _state_paths.intern(spawn.path, spawn.path.ptr(), _tick_count, 0);
+		uint32_t texture_id = _state_textures.intern(spawn.texture, spawn.texture.ptr(), _tick_count, 0);
+		uint32_t data_id = spawn.custom_data.is_empty() ? 0 : _state_data.intern(spawn.custom_data, spawn.custom_data.id(), _tick_count, 0);
+		ERR_FAIL_COND_V_MSG(texture_id > UINT16_MAX, PackedByteArray(), "Too many distinct BulletTextures to save state.");
+		w += encode_uint64(spawn.due, w);
+		w += encode_float(spawn.position.x, w);
+		w += encode_float(spawn.position.y, w);
+		w += encode_uint32(path_id, w);
+		w += encode_uint16(texture_id, w);
+		w += encode_uint32(data_id, w);
+		w += encode_uint32(_state_paths.get_generation(path_id), w);
+		w += encode_uint32(_state_textures.get_generation(texture_id), w);
+		w += encode_uint32(_state_data.get_generation(data_id), w);
+	}
+
+	for (uint32_t i = 0; i < pattern_count; i++) {
+		const PatternRunner &runner = i < _patterns.size() ? _patterns[i] : _started_patterns[i - _patterns.size()];
+		uint32_t pattern_id = _state_patterns.intern(runner.pattern, runner.pattern.ptr(), _tick_count, 0);
+		w += encode_uint32(pattern_id, w);
+		w += encode_uint32(_state_patterns.get_generation(pattern_id), w);
+		w += encode_uint32(runner.id, w);
+		w += encode_float(runner.origin.x, w);
+		w += encode_float(runner.origin.y, w);
+		w += encode_float(runner.rotation, w);
+		w += encode_float(runner.target.x, w);
+		w += encode_float(runner.target.y, w);
+		w += encode_uint32(runner.pc, w);
+		w += encode_uint32(runner.wait, w);
+		w += encode_float(runner.direction, w);
+		w += encode_float(runner.speed, w);
+		w += encode_float(runner.arc, w);
+		w += encode_float(runner.radius, w);
+		w += encode_uint32(runner.shots, w);
+		*w++ = i >= _patterns.size();
+		w += encode_uint16(runner.loops.size(), w);
+		for (uint32_t l = 0; l < runner.loops.size(); l++) {
+			w += encode_uint32(runner.loops[l].x, w);
+			w += encode_uint32(runner.loops[l].y, w);
+		}
+	}
+
+	return state;
+}
+
+Error BulletServer::load_state(const PackedByteArray &p_state) {
+	ERR_FAIL_NULL_V_MSG(bullet_pool, ERR_UNCONFIGURED, "Cannot load state into a BulletServer that is not in the scene tree.");
+	ERR_FAIL_COND_V_MSG(p_state.size() < STATE_HEADER_SIZE, ERR_INVALID_DATA, "Bullet state is too short.");
+
+	const uint8_t *r = p_state.ptr();
+	ERR_FAIL_COND_V_MSG(decode_uint32(r) != STATE_MAGIC, ERR_FILE_UNRECOGNIZED, "Data is not a saved bullet state.");
+	ERR_FAIL_COND_V_MSG(decode_uint32(r + 4) != STATE_VERSION, ERR_FILE_UNRECOGNIZED, "Bullet state was saved by an incompatible version.");
+	uint32_t count = decode_uint32(r + 8);
+	ERR_FAIL_COND_V_MSG(count > (uint32_t)bullet_pool_size, ERR_OUT_OF_MEMORY, "Bullet state holds more bullets than this server's pool.");
+	uint32_t scheduled_count = decode_uint32(r + 32);
+	uint32_t pattern_count = decode_uint32(r + 36);
+	int64_t fixed_size = STATE_HEADER_SIZE + (int64_t)count * STATE_BULLET_SIZE + (int64_t)scheduled_count * STATE_SCHEDULED_SIZE;
+	ERR_FAIL_COND_V_MSG(p_state.size() < fixed_size + (int64_t)pattern_count * STATE_PATTERN_SIZE, ERR_FILE_CORRUPT, "Bullet state size does not match its bullet count.");
+
+	//validate every id first so a failed load leaves the server untouched. an id pruned and reused since the
+	//snapshot was saved has a newer generation, so it fails here rather than restoring someone else's data
+	const uint8_t *bullets = r + STATE_HEADER_SIZE;
+	for (uint32_t i = 0; i < count; i++) {
+		const uint8_t *b = bullets + i * STATE_BULLET_SIZE;
+		const uint8_t *g = b + STATE_BULLET_GENERATIONS;
+		uint32_t path_id = decode_uint32(b + 44);
+		uint32_t texture_id = decode_uint16(b + 48);
+		uint32_t data_id = decode_uint32(b + 50);
+		ERR_FAIL_COND_V_MSG((path_id != 0 && !_state_paths.has(path_id, decode_uint32(g))) || (texture_id != 0 && !_state_textures.has(texture_id, decode_uint32(g + 4))) || (data_id != 0 && !_state_data.has(data_id, decode_uint32(g + 8))),
+				ERR_DOES_NOT_EXIST, "Bullet state references data that is no longer retained. Increase state_retention_ticks to load older states.");
+	}
+	const uint8_t *scheduled = bullets + count * STATE_BULLET_SIZE;
+	for (uint32_t i = 0; i < scheduled_count; i++) {
+		const uint8_t *s = scheduled + i * STATE_SCHEDULED_SIZE;
+		uint32_t path_id = decode_uint32(s + 16);
+		uint32_t texture_id = decode_uint16(s + 20);
+		uint32_t data_id = decode_uint32(s + 22);
+		ERR_FAIL_COND_V_MSG(!_state_paths.has(path_id, decode_uint32(s + 26)) || (texture_id != 0 && !_state_textures.has(texture_id, decode_uint32(s + 30))) || (data_id != 0 && !_state_data.has(data_id, decode_uint32(s + 34))),
+				ERR_DOES_NOT_EXIST, "Bullet state references data that is no longer retained. Increase state_retention_ticks to load older states.");
+	}
+	const uint8_t *patterns = r + fixed_size;
+	const uint8_t *end = r + p_state.size();
+	const uint8_t *p = patterns;
+	for (uint32_t i = 0; i < pattern_count; i++) {
+		ERR_FAIL_COND_V_MSG(end - p < STATE_PATTERN_SIZE, ERR_FILE_CORRUPT, "Bullet state size does not match its bullet count.");
+		uint32_t pattern_id = decode_uint32(p);
+		ERR_FAIL_COND_V_MSG(!_state_patterns.has(pattern_id, decode_uint32(p + 4)), ERR_DOES_NOT_EXIST, "Bullet state references data that is no longer retained. Increase state_retention_ticks to load older states.");
+		p += STATE_PATTERN_SIZE + decode_uint16(p + 61) * 8;
+	}
+	ERR_FAIL_COND_V_MSG(p != end, ERR_FILE_CORRUPT, "Bullet state size does not match its bullet count.");
+
+	RenderingServer *rs = RS::get_singleton();
+	for (int i = count; i < live_bullet_count; i++) {
+		rs->canvas_item_set_visible(bullet_pool[i]->get_ci_rid(), false);
+		bullet_pool[i]->render_shown = false;
+	}
+
+	_spawn_serial = decode_uint32(r + 12);
+	_sim_clock = decode_uint64(r + 16);
+	_tick_count = decode_uint64(r + 24);
+	//the snapshot's pending spawns replace the current ones, so none are lost or fired twice
+	clear_scheduled_spawns();
+	_rebuild_schedule();
+	for (uint32_t i = 0; i < scheduled_count; i++) {
+		const uint8_t *s = scheduled + i * STATE_SCHEDULED_SIZE;
+		uint32_t data_id = decode_uint32(s + 22);
+		uint32_t texture_id = decode_uint16(s + 20);
+		_schedule_spawn(decode_uint64(s), Vector2(decode_float(s + 8), decode_float(s + 12)), _state_paths.get(decode_uint32(s + 16)),
+				texture_id ? _state_textures.get(texture_id) : Ref<BulletTexture>(), data_id ? _state_data.get(data_id) : Dictionary());
+	}
+	//pattern runners pick up exactly where they were, so resimulated ticks fire the same volleys
+	_patterns.clear();
+	_started_patterns.clear();
+	_next_pattern_id = decode_uint32(r + 40);
+	p = patterns;
+	for (uint32_t i = 0; i < pattern_count; i++) {
+		PatternRunner runner;
+		runner.pattern = _state_patterns.get(decode_uint32(p));
+		runner.id = decode_uint32(p + 8);
+		runner.origin = Vector2(decode_float(p + 12), decode_float(p + 16));
+		runner.rotation = decode_float(p + 20);
+		runner.target = Vector2(decode_float(p + 24), decode_float(p + 28));
+		runner.pc = decode_uint32(p + 32);
+		runner.wait = (int32_t)decode_uint32(p + 36);
+		runner.direction = decode_float(p + 40);
+		runner.speed = decode_float(p + 44);
+		runner.arc = decode_float(p + 48);
+		runner.radius = decode_float(p + 52);
+		runner.shots = (int32_t)decode_uint32(p + 56);
+		bool started = p[60];
+		runner.loops.resize(decode_uint16(p + 61));
+		p += STATE_PATTERN_SIZE;
+		for (uint32_t l = 0; l < runner.loops.size(); l++) {
+			runner.loops[l] = Vector2i(decode_uint32(p), decode_uint32(p + 4));
+			p += 8;
+		}
+		if (started) {
+			_started_patterns.push_back(runner);
+		} else {
+			_patterns.push_back(runner);
+		}
+	}
+	live_bullet_count = count;
+	//snapshots can be taken between a pop and the rebuild it needs
+	_heap_dirty = true;
+	_cancel_grid_dirty = true;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const uint8_t *b = bullets + i * STATE_BULLET_SIZE;
+		Bullet *bullet = bullet_pool[i];
+
+		bullet->transform.columns[0] = Vector2(decode_float(b), decode_float(b + 4));
+		bullet->transform.columns[1] = Vector2(decode_float(b + 8), decode_float(b + 12));
+		bullet->transform.columns[2] = Vector2(decode_float(b + 16), decode_float(b + 20));
+		bullet->spawntime = decode_uint64(b + 24);
+		bullet->path_start = decode_uint64(b + 32);
+		bullet->serial = decode_uint32(b + 40);
+		bullet->path_state_id = decode_uint32(b + 44);
+		bullet->texture_state_id = decode_uint16(b + 48);
+		bullet->data_state_id = decode_uint32(b + 50);
+		bullet->state = Bullet::State(b[54]);
+		bullet->program_pc = decode_uint16(b + 55);
+		bullet->program_wait = decode_uint16(b + 57);
+		bullet->program_loop_pc = decode_uint16(b + 59);
+		bullet->program_loop_left = decode_uint16(b + 61);
+		bullet->program_ramp_ticks = decode_uint16(b + 63);
+		bullet->program_speed = decode_float(b + 65);
+		bullet->program_ramp = decode_float(b + 69);
+		bullet->heading = decode_float(b + 73);
+		bullet->emissions = decode_uint32(b + 77);
+		bullet->homing_velocity = Vector2(decode_float(b + 81), decode_float(b + 85));
+		bullet->impulse_velocity = Vector2(decode_float(b + 89), decode_float(b + 93));
+		bullet->impulse_force = Vector2(decode_float(b + 97), decode_float(b + 101));
+		for (int s = 0; s < BulletTexture::PAYLOAD_SLOTS; s++) {
+			bullet->payload_ints[s * bullet->payload_stride] = (int32_t)decode_uint32(b + 105 + s * 4);
+			bullet->payload_floats[s * bullet->payload_stride] = decode_float(b + 105 + (BulletTexture::PAYLOAD_SLOTS + s) * 4);
+		}
+
+		bullet->path = bullet->path_state_id ? _state_paths.get(bullet->path_state_id) : Ref<BulletPath>();
+		uint32_t data_id = 0;
+		if (bullet->data_state_id) {
+			const Dictionary &data = _state_data.get(bullet->data_state_id);
+			data_id = _custom_data.acquire(data, data.id());
+		}
+		_custom_data.release(bullet->data_id);
+		bullet->data_id = data_id;
+
+		//redrawing is the expensive part of a restore, so only do it for slots whose texture changed
+		const Ref<BulletTexture> &texture = bullet->texture_state_id ? _state_textures.get(bullet->texture_state_id) : Ref<BulletTexture>();
+		if (texture.is_valid()) {
+			_set_bullet_type(bullet, texture);
+		}
+		bullet->program = texture.is_valid() ? texture->get_program() : Ref<BulletProgram>();
+		//shown again, if in view, by the next render sync
+		bullet->previous_transform = bullet->transform;
+		if (bullet->render_shown) {
+			rs->canvas_item_set_visible(bullet->get_ci_rid(), false);
+			bullet->render_shown = false;
+		}
+		bullet->render_dirty = true;
+	}
+
+	return OK;
+}
+
+static void _encode_varint(uint32_t p_value, LocalVector<uint8_t> &r_out) {
+	while (p_value >= 0x80) {
+		r_out.push_back((p_value & 0x7F) | 0x80);
+		p_value >>= 7;
+	}
+	r_out.push_back(p_value);
+}
+
+static bool _decode_varint(const uint8_t *&r_ptr, const uint8_t *p_end, uint32_t &r_value) {
+	r_value = 0;
+	for (int shift = 0; shift < 32; shift += 7) {
+		if (r_ptr >= p_end) {
+			return false;
+		}
+		uint8_t byte = *r_ptr++;
+		r_value |= uint32_t(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+PackedByteArray BulletServer::save_state_delta(const PackedByteArray &p_reference) {
+	PackedByteArray state = save_state();
+	ERR_FAIL_COND_V(state.is_empty(), PackedByteArray());
+
+	//xor against the reference, then store the result as alternating runs of zeroes and literal bytes
+	const uint8_t *cur = state.ptr();
+	const uint8_t *ref = p_reference.ptr();
+	uint32_t size = state.size();
+	uint32_t ref_size = p_reference.size();
+
+	LocalVector<uint8_t> delta;
+	delta.reserve(size / 4);
+	delta.resize(8);
+	encode_uint32(STATE_DELTA_MAGIC, delta.ptr());
+	encode_uint32(size, delta.ptr() + 4);
+
+	uint32_t i = 0;
+	while (i < size) {
+		uint32_t zero_start = i;
+		while (i < size && cur[i] == (i < ref_size ? ref[i] : 0)) {
+			i++;
+		}
+		uint32_t literal_start = i;
+		//short runs of matching bytes are cheaper to keep inside the literal
+		while (i < size) {
+			uint32_t run = 0;
+			while (i + run < size && run < 4 && cur[i + run] == (i + run < ref_size ? ref[i + run] : 0)) {
+				run++;
+			}
+			if (run >= 4 || i + run == size) {
+				break;
+			}
+			i += run + 1;
+		}
+		_encode_varint(literal_start - zero_start, delta);
+		_encode_varint(i - literal_start, delta);
+		for (uint32_t j = literal_start; j < i; j++) {
+			delta.push_back(cur[j] ^ (j < ref_size ? ref[j] : 0));
+		}
+	}
+
+	PackedByteArray out;
+	out.resize(delta.size());
+	memcpy(out.ptrw(), delta.ptr(), delta.size());
+	return out;
+}
+
+bool BulletServer::_decode_state_delta(const PackedByteArray &p_reference, const PackedByteArray &p_delta, PackedByteArray &r_state) const {
+	ERR_FAIL_COND_V_MSG(p_delta.size() < 8 || decode_uint32(p_delta.ptr()) != STATE_DELTA_MAGIC, false, "Data is not a bullet state delta.");
+
+	uint32_t size = decode_uint32(p_delta.ptr() + 4);
+	r_state.resize(size);
+	uint8_t *w = r_state.ptrw();
+	const uint8_t *ref = p_reference.ptr();
+	uint32_t ref_size = p_reference.size();
+
+	const uint8_t *r = p_delta.ptr() + 8;
+	const uint8_t *end = p_delta.ptr() + p_delta.size();
+	uint32_t i = 0;
+	while (i < size) {
+		uint32_t zeroes, literals;
+		ERR_FAIL_COND_V_MSG(!_decode_varint(r, end, zeroes) || !_decode_varint(r, end, literals), false, "Bullet state delta is truncated.");
+		ERR_FAIL_COND_V_MSG(i + zeroes + literals > size || r + literals > end, false, "Bullet state delta is corrupt.");
+		for (uint32_t j = 0; j < zeroes; j++, i++) {
+			w[i] = i < ref_size ? ref[i] : 0;
+		}
+		for (uint32_t j = 0; j < literals; j++, i++) {
+			w[i] = *r++ ^ (i < ref_size ? ref[i] : 0);
+		}
+	}
+	return true;
+}
+
+Error BulletServer::load_state_delta(const PackedByteArray &p_reference, const PackedByteArray &p_delta) {
+	PackedByteArray state;
+	if (!_decode_state_delta(p_reference, p_delta, state)) {
+		return ERR_FILE_CORRUPT;
+	}
+	return load_state(state);
+}
+
+Array BulletServer::get_live_bullets() {
+	Array bullets;
+	for (int i = 0; i < live_bullet_count; i++) {
+		bullets.push_back(bullet_pool[i]);
+	}
+	return bullets;
+}
+
+int BulletServer::get_live_bullet_count() {
+	return live_bullet_count;
+}
+
+Array BulletServer::get_live_bullet_positions() {
+	Array bullet_positions;
+	for (int i = 0; i < live_bullet_count; i++) {
+		bullet_positions.push_back(bullet_pool[i]->get_position());
+	}
+	return bullet_positions;
+}
+
+void BulletServer::set_bullet_pool_size(int p_size) {
+	ERR_FAIL_COND_MSG(is_inside_tree() && !Engine::get_singleton()->is_editor_hint(), "Cannot resize bullet pool while server in in scene tree.");
+	if (p_size > -1)
+		bullet_pool_size = p_size;
+}
+
+int BulletServer::get_bullet_pool_size() const {
+	return bullet_pool_size;
+}
+
+void BulletServer::set_max_lifetime(float p_time) {
+	max_lifetime = p_time;
+}
+
+float BulletServer::get_max_lifetime() const {
+	return max_lifetime;
+}
+
+void BulletServer::set_pop_on_collide(bool p_enabled) {
+	pop_on_collide = p_enabled;
+}
+
+bool BulletServer::get_pop_on_collide() const {
+	return pop_on_collide;
+}
+
+void BulletServer::set_max_collisions_per_bullet(int p_count) {
+	max_collisions_per_bullet = p_count;
+}
+
+int BulletServer::get_max_collisions_per_bullet() const {
+	return max_collisions_per_bullet;
+}
+
+void BulletServer::set_sweep_collisions(bool p_enabled) {
+	sweep_collisions = p_enabled;
+}
+
+bool BulletServer::get_sweep_collisions() const {
+	return sweep_collisions;
+}
+
+void BulletServer::set_max_collision_substeps(int p_substeps) {
+	ERR_FAIL_COND_MSG(p_substeps < 1, "Collisions need at least one step.");
+	max_collision_substeps = p_substeps;
+}
+
+int BulletServer::get_max_collision_substeps() const {
+	return max_collision_substeps;
+}
+
+void BulletServer::set_play_area_mode(AreaMode p_mode) {
+	play_area_mode = p_mode;
+	notify_property_list_changed();
+}
+
+BulletServer::AreaMode BulletServer::get_play_area_mode() const {
+	return play_area_mode;
+}
+
+void BulletServer::set_play_area_rect(const Rect2 &p_rect) {
+	play_area_rect = p_rect;
+}
+
+Rect2 BulletServer::get_play_area_rect() const {
+	return play_area_rect;
+}
+
+void BulletServer::set_play_area_margin(float p_margin) {
 	play_area_margin = p_margin;
 }
 
@@ -373,6 +2452,15 @@ bool BulletServer::get_play_area_allow_incoming() const {
 	return play_area_allow_incoming;
 }
 
+void BulletServer::set_play_area_exit_mode(ExitMode p_mode) {
+	play_area_exit_mode = p_mode;
+	notify_property_list_changed();
+}
+
+BulletServer::ExitMode BulletServer::get_play_area_exit_mode() const {
+	return play_area_exit_mode;
+}
+
 void BulletServer::set_relay_autoconnect(bool p_enabled) {
 	relay_autoconnect = p_enabled;
 }
@@ -381,6 +2469,504 @@ bool BulletServer::get_relay_autoconnect() const {
 	return relay_autoconnect;
 }
 
+void BulletServer::add_cancel_server(BulletServer *p_server) {
+	ERR_FAIL_NULL(p_server);
+	ObjectID id = p_server->get_instance_id();
+	if (_cancel_servers.find(id) < 0) {
+		_cancel_servers.push_back(id);
+	}
+}
+
+void BulletServer::remove_cancel_server(BulletServer *p_server) {
+	ERR_FAIL_NULL(p_server);
+	int64_t index = _cancel_servers.find(p_server->get_instance_id());
+	if (index >= 0) {
+		_cancel_servers.remove_at(index);
+	}
+}
+
+void BulletServer::clear_cancel_servers() {
+	_cancel_servers.clear();
+}
+
+Array BulletServer::get_cancel_servers() const {
+	Array servers = Array();
+	for (uint32_t i = 0; i < _cancel_servers.size(); i++) {
+		Object *server = ObjectDB::get_instance(_cancel_servers[i]);
+		if (server) {
+			servers.append(server);
+		}
+	}
+	return servers;
+}
+
+void BulletServer::set_cancel_pop(bool p_enabled) {
+	cancel_pop = p_enabled;
+}
+
+bool BulletServer::get_cancel_pop() const {
+	return cancel_pop;
+}
+
+void BulletServer::_update_governor(uint64_t p_tick_usec) {
+	//render submissions since the previous tick count towards this tick's share of the frame
+	double tick_msec = (p_tick_usec + _governor_render_usec) / 1000.0;
+	_governor_render_usec = 0;
+
+	GovernorLevel level = _governor_level;
+	if (tick_msec > budget_msec) {
+		_governor_calm_ticks = 0;
+		if (level < GOVERNOR_REFUSE_SPAWNS) {
+			level = GovernorLevel(level + 1);
+		}
+	} else if (tick_msec < budget_msec * GOVERNOR_RECOVERY_RATIO && level > GOVERNOR_NONE) {
+		_governor_calm_ticks++;
+		if (_governor_calm_ticks >= budget_recovery_ticks) {
+			_governor_calm_ticks = 0;
+			level = GovernorLevel(level - 1);
+		}
+	} else {
+		_governor_calm_ticks = 0;
+	}
+
+	if (level != _governor_level) {
+		_governor_level = level;
+		emit_signal("governor_level_changed", _governor_level);
+	}
+}
+
+void BulletServer::_update_focus_positions() {
+	_focus_positions.clear();
+	if (budget_focus_group == StringName()) {
+		return;
+	}
+
+	List<Node *> nodes;
+	get_tree()->get_nodes_in_group(budget_focus_group, &nodes);
+	for (Node *node : nodes) {
+		Node2D *node_2d = Object::cast_to<Node2D>(node);
+		if (node_2d) {
+			_focus_positions.push_back(node_2d->get_global_position());
+		}
+	}
+}
+
+bool BulletServer::_should_stagger_collision(const Bullet *p_bullet) const {
+	//bullets near a focus are always checked, the rest are checked on alternating ticks
+	Vector2 position = p_bullet->get_position();
+	float radius_squared = budget_focus_radius * budget_focus_radius;
+	for (uint32_t i = 0; i < _focus_positions.size(); i++) {
+		if (position.distance_squared_to(_focus_positions[i]) <= radius_squared) {
+			return false;
+		}
+	}
+	return ((p_bullet->serial + _tick_count) & 1) != 0;
+}
+
+void BulletServer::_sync_render() {
+	uint64_t trace_start = BulletTracer::get_singleton()->begin_span();
+	RenderingServer *rs = RS::get_singleton();
+	//the governor culls even with culling disabled, and trades the margin for fewer bullets to draw
+	bool governed = _governor_level >= GOVERNOR_CULL_RENDER;
+	bool culling = render_culling || governed;
+	Rect2 view_rect = culling ? _get_view_rect().grow(governed ? 0 : render_cull_margin) : Rect2();
+	float fraction = render_interpolation ? _get_interpolation_fraction() : 1.0;
+	if (render_mode == RENDER_MULTIMESH) {
+		int drawn = _sync_batches(culling, view_rect, fraction);
+		BulletTracer::get_singleton()->end_span("update_batches", this, trace_start, drawn);
+		return;
+	}
+	int pushed = 0;
+	for (int i = 0; i < live_bullet_count; i++) {
+		Bullet *bullet = bullet_pool[i];
+		if (bullet->is_popped()) {
+			continue;
+		}
+		if (culling && !view_rect.has_point(bullet->get_position())) {
+			if (bullet->render_shown) {
+				rs->canvas_item_set_visible(bullet->get_ci_rid(), false);
+				bullet->render_shown = false;
+			}
+			continue;
+		}
+		//only transforms that changed since the last sync are sent, so frames without a physics tick cost no render commands
+		//unless the bullet moved during the last tick and is being interpolated
+		bool moving = render_interpolation && bullet->previous_transform != bullet->transform;
+		if (bullet->render_dirty || moving) {
+			rs->canvas_item_set_transform(bullet->get_ci_rid(), moving ? bullet->previous_transform.interpolate_with(bullet->transform, fraction) : bullet->transform);
+			bullet->render_dirty = false;
+			pushed++;
+		}
+		if (!bullet->render_shown) {
+			rs->canvas_item_set_visible(bullet->get_ci_rid(), true);
+			bullet->render_shown = true;
+		}
+	}
+	trace_start = BulletTracer::get_singleton()->end_span("update_transforms", this, trace_start, pushed);
+	//pop effects are batched even when bullets are not
+	if (!_batches.is_empty()) {
+		int drawn = _sync_batches(culling, view_rect, fraction);
+		BulletTracer::get_singleton()->end_span("update_batches", this, trace_start, drawn);
+	}
+}
+
+static _FORCE_INLINE_ void _write_instance(float *w, const Transform2D &p_xform, const Size2 &p_size, const Color &p_color, const Rect2 &p_uv) {
+	//2D instance layout: transform rows padded to 4, then color, then custom data
+	w[0] = p_xform.columns[0].x * p_size.x;
+	w[1] = p_xform.columns[1].x * p_size.y;
+	w[2] = 0.0;
+	w[3] = p_xform.columns[2].x;
+	w[4] = p_xform.columns[0].y * p_size.x;
+	w[5] = p_xform.columns[1].y * p_size.y;
+	w[6] = 0.0;
+	w[7] = p_xform.columns[2].y;
+	w[8] = p_color.r;
+	w[9] = p_color.g;
+	w[10] = p_color.b;
+	w[11] = p_color.a;
+	w[12] = p_uv.position.x;
+	w[13] = p_uv.position.y;
+	w[14] = p_uv.size.x;
+	w[15] = p_uv.size.y;
+}
+
+static _FORCE_INLINE_ Rect2 _frame_uv(const Rect2 &p_uv, int p_hframes, int p_frame) {
+	return Rect2(p_uv.position + Vector2(p_frame % p_hframes, p_frame / p_hframes) * p_uv.size, p_uv.size);
+}
+
+int BulletServer::_sync_batches(bool p_culling, const Rect2 &p_view_rect, float p_fraction) {
+	RenderingServer *rs = RS::get_singleton();
+	_atlas.commit();
+
+	_render_queue.clear();
+	if (render_mode == RENDER_MULTIMESH) {
+		for (int i = 0; i < live_bullet_count; i++) {
+			Bullet *bullet = bullet_pool[i];
+			if (bullet->is_popped() || !_update_bullet_type(bullet)) {
+				continue;
+			}
+			if (_types[bullet->type_id].batch < 0 || (p_culling && !p_view_rect.has_point(bullet->get_position()))) {
+				continue;
+			}
+			_render_queue.push_back(bullet);
+		}
+	}
+
+	//bullets are grouped by type within their batch, in type order, so overlapping bullets always stack the same way
+	for (uint32_t i = 0; i < _batches.size(); i++) {
+		_batches[i].count = 0;
+	}
+	_render_type_cursor.resize(_types.size());
+	for (uint32_t i = 0; i < _render_type_cursor.size(); i++) {
+		_render_type_cursor[i] = 0;
+	}
+	for (uint32_t i = 0; i < _render_queue.size(); i++) {
+		_render_type_cursor[_render_queue[i]->type_id]++;
+	}
+	for (uint32_t i = 1; i < _types.size(); i++) {
+		uint32_t drawn = _render_type_cursor[i];
+		if (drawn > 0) {
+			RenderBatch &batch = _batches[_types[i].batch];
+			_render_type_cursor[i] = batch.count;
+			batch.count += drawn;
+		}
+	}
+
+	//pop effects follow the bullets of their batch. they age with the clock bullets are drawn at, a tick behind when interpolating
+	double now = _sim_clock;
+	if (render_interpolation) {
+		now -= (1.0 - p_fraction) * 1000000.0 / _get_ticks_per_second();
+	}
+	for (uint32_t i = 0; i < _batches.size(); i++) {
+		_batches[i].fill = _batches[i].count;
+	}
+	_render_effect_queue.clear();
+	for (uint32_t i = 0; i < _effects.size(); i++) {
+		//a type changed since the last tick may have lost its effect, which the next tick expires
+		if (_types[_effects[i].type_id].effect_batch < 0) {
+			continue;
+		}
+		if (p_culling && !p_view_rect.has_point(_effects[i].transform.get_origin())) {
+			continue;
+		}
+		_batches[_types[_effects[i].type_id].effect_batch].count++;
+		_render_effect_queue.push_back(i);
+	}
+
+	for (uint32_t i = 0; i < _batches.size(); i++) {
+		RenderBatch &batch = _batches[i];
+		if (batch.count > batch.capacity) {
+			//reallocating drops the instance data, which is rewritten in full below anyway
+			batch.capacity = MAX(batch.capacity * 2, batch.count);
+			rs->multimesh_allocate_data(batch.multimesh, batch.capacity, RS::MULTIMESH_TRANSFORM_2D, true, true);
+			batch.instances.resize(batch.capacity * BATCH_INSTANCE_FLOATS);
+			batch.buffer.resize(batch.capacity * BATCH_INSTANCE_FLOATS);
+		}
+		batch.write = batch.count > 0 ? batch.instances.ptr() : nullptr;
+	}
+
+	for (uint32_t i = 0; i < _render_queue.size(); i++) {
+		Bullet *bullet = _render_queue[i];
+		const BulletType &type = _types[bullet->type_id];
+		bool moving = render_interpolation && bullet->previous_transform != bullet->transform;
+		Transform2D xform = moving ? bullet->previous_transform.interpolate_with(bullet->transform, p_fraction) : bullet->transform;
+		int frame = type.frames > 1 ? _get_animation_frame(type, bullet) : 0;
+		float *w = _batches[type.batch].write + _render_type_cursor[bullet->type_id]++ * BATCH_INSTANCE_FLOATS;
+		_write_instance(w, xform, type.sprite_size, type.modulate, _frame_uv(type.uv, type.hframes, frame));
+	}
+
+	for (uint32_t i = 0; i < _render_effect_queue.size(); i++) {
+		const PopEffect &effect = _effects[_render_effect_queue[i]];
+		const BulletType &type = _types[effect.type_id];
+		RenderBatch &batch = _batches[type.effect_batch];
+		float progress = CLAMP((now - effect.start) / type.effect_usec, 0.0, 1.0);
+		int frame = type.effect_frames > 0 ? MIN(int(progress * type.effect_frames), type.effect_frames - 1) : effect.frame;
+		Color color = type.modulate;
+		if (type.effect_fade) {
+			color.a *= 1.0 - progress;
+		}
+		float *w = batch.write + batch.fill++ * BATCH_INSTANCE_FLOATS;
+		_write_instance(w, effect.transform, type.effect_size * Math::lerp(1.0f, type.effect_scale, progress), color, _frame_uv(type.effect_uv, type.effect_hframes, frame));
+	}
+
+	for (uint32_t i = 0; i < _batches.size(); i++) {
+		RenderBatch &batch = _batches[i];
+		batch.write = nullptr;
+		if (batch.count > 0) {
+			//only the visible instances are copied. the buffer must still cover the whole multimesh, so it keeps its size
+			memcpy(batch.buffer.ptrw(), batch.instances.ptr(), batch.count * BATCH_INSTANCE_FLOATS * sizeof(float));
+			rs->multimesh_set_buffer(batch.multimesh, batch.buffer);
+		}
+		if (batch.count != batch.visible) {
+			rs->multimesh_set_visible_instances(batch.multimesh, batch.count);
+			batch.visible = batch.count;
+		}
+	}
+	return _render_queue.size() + _render_effect_queue.size();
+}
+
+float BulletServer::_get_interpolation_fraction() const {
+	float fraction = Engine::get_singleton()->get_physics_interpolation_fraction();
+	if (sim_ticks_per_second > 0) {
+		//time left over from the server's own ticks, plus the time since the last physics frame
+		fraction = (_sim_accumulator + fraction * _sim_frame_step) * sim_ticks_per_second;
+	}
+	return CLAMP(fraction, 0.0, 1.0);
+}
+
+int BulletServer::_get_ticks_per_second() const {
+	return sim_ticks_per_second > 0 ? sim_ticks_per_second : Engine::get_singleton()->get_physics_ticks_per_second();
+}
+
+Rect2 BulletServer::_get_view_rect() const {
+	Viewport *viewport = get_viewport();
+	return viewport->get_canvas_transform().affine_inverse().xform(viewport->get_visible_rect());
+}
+
+void BulletServer::set_render_culling(bool p_enabled) {
+	render_culling = p_enabled;
+}
+
+bool BulletServer::get_render_culling() const {
+	return render_culling;
+}
+
+void BulletServer::set_render_cull_margin(float p_margin) {
+	render_cull_margin = p_margin;
+}
+
+float BulletServer::get_render_cull_margin() const {
+	return render_cull_margin;
+}
+
+void BulletServer::set_render_interpolation(bool p_enabled) {
+	if (p_enabled && !render_interpolation) {
+		//start from where bullets are now, not from wherever they were when interpolation was last on
+		for (int i = 0; i < live_bullet_count; i++) {
+			bullet_pool[i]->previous_transform = bullet_pool[i]->transform;
+		}
+	}
+	render_interpolation = p_enabled;
+}
+
+bool BulletServer::get_render_interpolation() const {
+	return render_interpolation;
+}
+
+void BulletServer::set_render_mode(RenderMode p_mode) {
+	ERR_FAIL_COND_MSG(is_inside_tree() && !Engine::get_singleton()->is_editor_hint(), "Cannot change render mode while server is in scene tree.");
+	render_mode = p_mode;
+}
+
+BulletServer::RenderMode BulletServer::get_render_mode() const {
+	return render_mode;
+}
+
+void BulletServer::set_render_effect_pool_size(int p_size) {
+	ERR_FAIL_COND_MSG(is_inside_tree() && !Engine::get_singleton()->is_editor_hint(), "Cannot resize effect pool while server is in scene tree.");
+	if (p_size > -1)
+		render_effect_pool_size = p_size;
+}
+
+int BulletServer::get_render_effect_pool_size() const {
+	return render_effect_pool_size;
+}
+
+int BulletServer::get_live_effect_count() const {
+	return _effects.size();
+}
+
+void BulletServer::set_budget_msec(float p_msec) {
+	budget_msec = p_msec;
+	if (budget_msec <= 0 && _governor_level != GOVERNOR_NONE) {
+		_governor_level = GOVERNOR_NONE;
+		emit_signal("governor_level_changed", _governor_level);
+	}
+}
+
+float BulletServer::get_budget_msec() const {
+	return budget_msec;
+}
+
+void BulletServer::set_budget_recovery_ticks(int p_ticks) {
+	budget_recovery_ticks = MAX(p_ticks, 1);
+}
+
+int BulletServer::get_budget_recovery_ticks() const {
+	return budget_recovery_ticks;
+}
+
+void BulletServer::set_budget_focus_group(const StringName &p_group) {
+	budget_focus_group = p_group;
+}
+
+StringName BulletServer::get_budget_focus_group() const {
+	return budget_focus_group;
+}
+
+void BulletServer::set_budget_focus_radius(float p_radius) {
+	budget_focus_radius = p_radius;
+}
+
+float BulletServer::get_budget_focus_radius() const {
+	return budget_focus_radius;
+}
+
+BulletServer::GovernorLevel BulletServer::get_governor_level() const {
+	return _governor_level;
+}
+
+void BulletServer::set_deterministic(bool p_enabled) {
+	deterministic = p_enabled;
+}
+
+bool BulletServer::get_deterministic() const {
+	return deterministic;
+}
+
+void BulletServer::set_sim_ticks_per_second(int p_ticks) {
+	ERR_FAIL_COND_MSG(p_ticks < 0, "Ticks per second can't be negative. Use 0 to follow the physics tick rate.");
+	sim_ticks_per_second = p_ticks;
+	_sim_accumulator = 0.0;
+}
+
+int BulletServer::get_sim_ticks_per_second() const {
+	return sim_ticks_per_second;
+}
+
+void BulletServer::set_state_retention_ticks(int p_ticks) {
+	state_retention_ticks = p_ticks;
+}
+
+int BulletServer::get_state_retention_ticks() const {
+	return state_retention_ticks;
+}
+
+void BulletServer::set_monitors_enabled(bool p_enabled) {
+#ifndef QUROBULLET_MONITORS_ENABLED
+	if (p_enabled) {
+		WARN_PRINT_ONCE("BulletServer monitors were compiled out of this build. Enabling them has no effect.");
+	}
+#endif
+	if (monitors_enabled == p_enabled) {
+		return;
+	}
+	monitors_enabled = p_enabled;
+
+	if (!is_inside_tree() || Engine::get_singleton()->is_editor_hint()) {
+		return;
+	}
+	if (monitors_enabled) {
+		_register_monitors();
+	} else {
+		_unregister_monitors();
+	}
+}
+
+bool BulletServer::get_monitors_enabled() const {
+	return monitors_enabled;
+}
+
+double BulletServer::get_monitor(Monitor p_monitor) const {
+	ERR_FAIL_INDEX_V(p_monitor, MONITOR_MAX, 0);
+	if (p_monitor == MONITOR_LIVE_BULLETS) {
+		return live_bullet_count;
+	}
+	if (p_monitor == MONITOR_GOVERNOR_LEVEL) {
+		return _governor_level;
+	}
+	return _monitor_values[p_monitor];
+}
+
+void BulletServer::_register_monitors() {
+#ifdef QUROBULLET_MONITORS_ENABLED
+	if (_monitors_registered) {
+		return;
+	}
+	Performance *performance = Performance::get_singleton();
+	for (int i = 0; i < MONITOR_MAX; i++) {
+		StringName id = vformat("%s/%s", get_name(), monitor_names[i]);
+		ERR_CONTINUE_MSG(performance->has_custom_monitor(id), vformat("Custom monitor \"%s\" already exists. Give each monitored BulletServer a unique name.", id));
+		Vector<Variant> args;
+		args.push_back(i);
+		performance->add_custom_monitor(id, Callable(this, "get_monitor"), args);
+		_monitor_ids.push_back(id);
+	}
+	_monitors_registered = true;
+#endif
+}
+
+void BulletServer::_unregister_monitors() {
+	if (!_monitors_registered) {
+		return;
+	}
+	Performance *performance = Performance::get_singleton();
+	for (uint32_t i = 0; i < _monitor_ids.size(); i++) {
+		if (performance->has_custom_monitor(_monitor_ids[i])) {
+			performance->remove_custom_monitor(_monitor_ids[i]);
+		}
+	}
+	_monitor_ids.clear();
+	_monitors_registered = false;
+}
+
+void BulletServer::_publish_monitors() {
+#ifdef QUROBULLET_MONITORS_ENABLED
+	if (!monitors_enabled) {
+		return;
+	}
+	//counters cover everything since the previous physics tick, times are reported in milliseconds
+	for (int i = 0; i < MONITOR_MAX; i++) {
+		if (i >= MONITOR_INTEGRATION_TIME && i <= MONITOR_RENDER_TIME) {
+			_monitor_values[i] = _monitor_counters[i] / 1000.0;
+		} else {
+			_monitor_values[i] = _monitor_counters[i];
+		}
+		_monitor_counters[i] = 0;
+	}
+#endif
+}
+
 void BulletServer::_validate_property(PropertyInfo &property) const {
 	if (property.name == "play_area_rect" && play_area_mode != MANUAL) {
 		property.usage = PROPERTY_USAGE_STORAGE;
@@ -389,6 +2975,10 @@ void BulletServer::_validate_property(PropertyInfo &property) const {
 	if (property.name == "play_area_margin" && play_area_mode != VIEWPORT) {
 		property.usage = PROPERTY_USAGE_STORAGE;
 	}
+
+	if (property.name == "play_area_allow_incoming" && play_area_exit_mode != EXIT_POP) {
+		property.usage = PROPERTY_USAGE_STORAGE;
+	}
 }
 
 void BulletServer::_bind_methods() {
@@ -396,10 +2986,38 @@ void BulletServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("spawn_volley", "position", "volley",  "texture", "custom_data"), &BulletServer::spawn_volley);
 	ClassDB::bind_method(D_METHOD("clear_bullets"), &BulletServer::clear_bullets);
 
+	ClassDB::bind_method(D_METHOD("schedule_spawn", "delay", "position", "path", "texture", "custom_data"), &BulletServer::schedule_spawn, DEFVAL(Dictionary()));
+	ClassDB::bind_method(D_METHOD("schedule_volley", "delay", "position", "volley", "texture", "custom_data"), &BulletServer::schedule_volley, DEFVAL(Dictionary()));
+	ClassDB::bind_method(D_METHOD("get_scheduled_spawn_count"), &BulletServer::get_scheduled_spawn_count);
+	ClassDB::bind_method(D_METHOD("clear_scheduled_spawns"), &BulletServer::clear_scheduled_spawns);
+
+	ClassDB::bind_method(D_METHOD("run_pattern", "pattern", "origin", "rotation", "target"), &BulletServer::run_pattern, DEFVAL(0.0), DEFVAL(Vector2()));
+	ClassDB::bind_method(D_METHOD("stop_pattern", "id"), &BulletServer::stop_pattern);
+	ClassDB::bind_method(D_METHOD("stop_all_patterns"), &BulletServer::stop_all_patterns);
+	ClassDB::bind_method(D_METHOD("is_pattern_running", "id"), &BulletServer::is_pattern_running);
+	ClassDB::bind_method(D_METHOD("set_pattern_origin", "id", "origin", "rotation"), &BulletServer::set_pattern_origin);
+	ClassDB::bind_method(D_METHOD("set_pattern_target", "id", "target"), &BulletServer::set_pattern_target);
+
+	ClassDB::bind_method(D_METHOD("start_recording", "path"), &BulletServer::start_recording);
+	ClassDB::bind_method(D_METHOD("stop_recording"), &BulletServer::stop_recording);
+	ClassDB::bind_method(D_METHOD("is_recording"), &BulletServer::is_recording);
+
+	ClassDB::bind_method(D_METHOD("start_replay", "path"), &BulletServer::start_replay);
+	ClassDB::bind_method(D_METHOD("replay_ticks", "ticks"), &BulletServer::replay_ticks, DEFVAL(-1));
+	ClassDB::bind_method(D_METHOD("stop_replay"), &BulletServer::stop_replay);
+	ClassDB::bind_method(D_METHOD("is_replaying"), &BulletServer::is_replaying);
+
 	ClassDB::bind_method(D_METHOD("get_live_bullets"), &BulletServer::get_live_bullets);
 	ClassDB::bind_method(D_METHOD("get_live_bullet_count"), &BulletServer::get_live_bullet_count);
 	ClassDB::bind_method(D_METHOD("get_live_bullet_positions"), &BulletServer::get_live_bullet_positions);
 
+	ClassDB::bind_method(D_METHOD("get_sim_time"), &BulletServer::get_sim_time);
+
+	ClassDB::bind_method(D_METHOD("save_state"), &BulletServer::save_state);
+	ClassDB::bind_method(D_METHOD("load_state", "state"), &BulletServer::load_state);
+	ClassDB::bind_method(D_METHOD("save_state_delta", "reference"), &BulletServer::save_state_delta);
+	ClassDB::bind_method(D_METHOD("load_state_delta", "reference", "delta"), &BulletServer::load_state_delta);
+
 	ClassDB::bind_method(D_METHOD("set_bullet_pool_size", "size"), &BulletServer::set_bullet_pool_size);
 	ClassDB::bind_method(D_METHOD("get_bullet_pool_size"), &BulletServer::get_bullet_pool_size);
 
@@ -412,6 +3030,12 @@ void BulletServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_max_collisions_per_bullet", "count"), &BulletServer::set_max_collisions_per_bullet);
 	ClassDB::bind_method(D_METHOD("get_max_collisions_per_bullet"), &BulletServer::get_max_collisions_per_bullet);
 
+	ClassDB::bind_method(D_METHOD("set_sweep_collisions", "enabled"), &BulletServer::set_sweep_collisions);
+	ClassDB::bind_method(D_METHOD("get_sweep_collisions"), &BulletServer::get_sweep_collisions);
+
+	ClassDB::bind_method(D_METHOD("set_max_collision_substeps", "substeps"), &BulletServer::set_max_collision_substeps);
+	ClassDB::bind_method(D_METHOD("get_max_collision_substeps"), &BulletServer::get_max_collision_substeps);
+
 	ClassDB::bind_method(D_METHOD("set_play_area_mode", "mode"), &BulletServer::set_play_area_mode);
 	ClassDB::bind_method(D_METHOD("get_play_area_mode"), &BulletServer::get_play_area_mode);
 
@@ -424,42 +3048,198 @@ void BulletServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_play_area_allow_incoming", "allow_incoming"), &BulletServer::set_play_area_allow_incoming);
 	ClassDB::bind_method(D_METHOD("get_play_area_allow_incoming"), &BulletServer::get_play_area_allow_incoming);
 
+	ClassDB::bind_method(D_METHOD("set_play_area_exit_mode", "mode"), &BulletServer::set_play_area_exit_mode);
+	ClassDB::bind_method(D_METHOD("get_play_area_exit_mode"), &BulletServer::get_play_area_exit_mode);
+
 	ClassDB::bind_method(D_METHOD("set_relay_autoconnect", "relay_autoconnect"), &BulletServer::set_relay_autoconnect);
 	ClassDB::bind_method(D_METHOD("get_relay_autoconnect"), &BulletServer::get_relay_autoconnect);
 
+	ClassDB::bind_method(D_METHOD("add_cancel_server", "server"), &BulletServer::add_cancel_server);
+	ClassDB::bind_method(D_METHOD("remove_cancel_server", "server"), &BulletServer::remove_cancel_server);
+	ClassDB::bind_method(D_METHOD("clear_cancel_servers"), &BulletServer::clear_cancel_servers);
+	ClassDB::bind_method(D_METHOD("get_cancel_servers"), &BulletServer::get_cancel_servers);
+
+	ClassDB::bind_method(D_METHOD("set_cancel_pop", "enabled"), &BulletServer::set_cancel_pop);
+	ClassDB::bind_method(D_METHOD("get_cancel_pop"), &BulletServer::get_cancel_pop);
+
+	ClassDB::bind_method(D_METHOD("set_deterministic", "enabled"), &BulletServer::set_deterministic);
+	ClassDB::bind_method(D_METHOD("get_deterministic"), &BulletServer::get_deterministic);
+
+	ClassDB::bind_method(D_METHOD("set_sim_ticks_per_second", "ticks"), &BulletServer::set_sim_ticks_per_second);
+	ClassDB::bind_method(D_METHOD("get_sim_ticks_per_second"), &BulletServer::get_sim_ticks_per_second);
+
+	ClassDB::bind_method(D_METHOD("set_state_retention_ticks", "ticks"), &BulletServer::set_state_retention_ticks);
+	ClassDB::bind_method(D_METHOD("get_state_retention_ticks"), &BulletServer::get_state_retention_ticks);
+
+	ClassDB::bind_method(D_METHOD("set_monitors_enabled", "enabled"), &BulletServer::set_monitors_enabled);
+	ClassDB::bind_method(D_METHOD("get_monitors_enabled"), &BulletServer::get_monitors_enabled);
+
+	ClassDB::bind_method(D_METHOD("get_monitor", "monitor"), &BulletServer::get_monitor);
+
+	ClassDB::bind_method(D_METHOD("set_budget_msec", "msec"), &BulletServer::set_budget_msec);
+	ClassDB::bind_method(D_METHOD("get_budget_msec"), &BulletServer::get_budget_msec);
+
+	ClassDB::bind_method(D_METHOD("set_budget_recovery_ticks", "ticks"), &BulletServer::set_budget_recovery_ticks);
+	ClassDB::bind_method(D_METHOD("get_budget_recovery_ticks"), &BulletServer::get_budget_recovery_ticks);
+
+	ClassDB::bind_method(D_METHOD("set_budget_focus_group", "group"), &BulletServer::set_budget_focus_group);
+	ClassDB::bind_method(D_METHOD("get_budget_focus_group"), &BulletServer::get_budget_focus_group);
+
+	ClassDB::bind_method(D_METHOD("set_budget_focus_radius", "radius"), &BulletServer::set_budget_focus_radius);
+	ClassDB::bind_method(D_METHOD("get_budget_focus_radius"), &BulletServer::get_budget_focus_radius);
+
+	ClassDB::bind_method(D_METHOD("set_render_culling", "enabled"), &BulletServer::set_render_culling);
+	ClassDB::bind_method(D_METHOD("get_render_culling"), &BulletServer::get_render_culling);
+
+	ClassDB::bind_method(D_METHOD("set_render_cull_margin", "margin"), &BulletServer::set_render_cull_margin);
+	ClassDB::bind_method(D_METHOD("get_render_cull_margin"), &BulletServer::get_render_cull_margin);
+
+	ClassDB::bind_method(D_METHOD("set_render_interpolation", "enabled"), &BulletServer::set_render_interpolation);
+	ClassDB::bind_method(D_METHOD("get_render_interpolation"), &BulletServer::get_render_interpolation);
+
+	ClassDB::bind_method(D_METHOD("set_render_mode", "mode"), &BulletServer::set_render_mode);
+	ClassDB::bind_method(D_METHOD("get_render_mode"), &BulletServer::get_render_mode);
+
+	ClassDB::bind_method(D_METHOD("set_render_effect_pool_size", "size"), &BulletServer::set_render_effect_pool_size);
+	ClassDB::bind_method(D_METHOD("get_render_effect_pool_size"), &BulletServer::get_render_effect_pool_size);
+	ClassDB::bind_method(D_METHOD("get_live_effect_count"), &BulletServer::get_live_effect_count);
+
+	ClassDB::bind_method(D_METHOD("get_governor_level"), &BulletServer::get_governor_level);
+
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "bullet_pool_size", PROPERTY_HINT_RANGE, "1,5000,1,or_greater"), "set_bullet_pool_size", "get_bullet_pool_size");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "max_lifetime", PROPERTY_HINT_RANGE, "0,300,0.01,or_greater"), "set_max_lifetime", "get_max_lifetime");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "pop_on_collide"), "set_pop_on_collide", "get_pop_on_collide");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_collisions_per_bullet", PROPERTY_HINT_RANGE, "1,256,1,or_greater"), "set_max_collisions_per_bullet", "get_max_collisions_per_bullet");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "sweep_collisions"), "set_sweep_collisions", "get_sweep_collisions");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_collision_substeps", PROPERTY_HINT_RANGE, "1,16,1,or_greater"), "set_max_collision_substeps", "get_max_collision_substeps");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deterministic"), "set_deterministic", "get_deterministic");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "sim_ticks_per_second", PROPERTY_HINT_RANGE, "0,240,1,or_greater"), "set_sim_ticks_per_second", "get_sim_ticks_per_second");
 	
 	ADD_GROUP("Play Area", "play_area_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "play_area_mode", PROPERTY_HINT_ENUM, "Viewport,Manual,Infinite"), "set_play_area_mode", "get_play_area_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::RECT2, "play_area_rect"), "set_play_area_rect", "get_play_area_rect");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "play_area_margin", PROPERTY_HINT_RANGE, "0,300,0.01,or_less,or_greater"), "set_play_area_margin", "get_play_area_margin");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "play_area_exit_mode", PROPERTY_HINT_ENUM, "Pop,Wrap,Bounce"), "set_play_area_exit_mode", "get_play_area_exit_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "play_area_allow_incoming"), "set_play_area_allow_incoming", "get_play_area_allow_incoming");
 
+	ADD_GROUP("Render", "render_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "render_mode", PROPERTY_HINT_ENUM, "Canvas Items,MultiMesh"), "set_render_mode", "get_render_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "render_culling"), "set_render_culling", "get_render_culling");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "render_cull_margin", PROPERTY_HINT_RANGE, "0,300,0.1,or_greater"), "set_render_cull_margin", "get_render_cull_margin");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "render_interpolation"), "set_render_interpolation", "get_render_interpolation");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "render_effect_pool_size", PROPERTY_HINT_RANGE, "0,5000,1,or_greater"), "set_render_effect_pool_size", "get_render_effect_pool_size");
+
+	ADD_GROUP("Cancel", "cancel_");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cancel_pop"), "set_cancel_pop", "get_cancel_pop");
+
 	ADD_GROUP("Relay", "relay_");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "relay_autoconnect"), "set_relay_autoconnect", "get_relay_autoconnect");
 
+	ADD_GROUP("State", "state_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "state_retention_ticks", PROPERTY_HINT_RANGE, "0,600,1,or_greater"), "set_state_retention_ticks", "get_state_retention_ticks");
+
+	ADD_GROUP("Budget", "budget_");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "budget_msec", PROPERTY_HINT_RANGE, "0,16.6,0.01,or_greater,suffix:ms"), "set_budget_msec", "get_budget_msec");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "budget_recovery_ticks", PROPERTY_HINT_RANGE, "1,300,1,or_greater"), "set_budget_recovery_ticks", "get_budget_recovery_ticks");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "budget_focus_group"), "set_budget_focus_group", "get_budget_focus_group");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "budget_focus_radius", PROPERTY_HINT_RANGE, "0,1000,0.1,or_greater"), "set_budget_focus_radius", "get_budget_focus_radius");
+
+	ADD_GROUP("Monitors", "monitors_");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "monitors_enabled"), "set_monitors_enabled", "get_monitors_enabled");
+
 	ADD_SIGNAL(MethodInfo("collisions_detected", PropertyInfo(Variant::DICTIONARY, "collisions")));
 	ADD_SIGNAL(MethodInfo("bullets_popped", PropertyInfo(Variant::ARRAY, "bullets")));
+	ADD_SIGNAL(MethodInfo("bullets_cancelled", PropertyInfo(Variant::ARRAY, "cancellations")));
+	ADD_SIGNAL(MethodInfo("governor_level_changed", PropertyInfo(Variant::INT, "level")));
 	BIND_ENUM_CONSTANT(VIEWPORT);
 	BIND_ENUM_CONSTANT(MANUAL);
 	BIND_ENUM_CONSTANT(INFINITE);
+
+	BIND_ENUM_CONSTANT(EXIT_POP);
+	BIND_ENUM_CONSTANT(EXIT_WRAP);
+	BIND_ENUM_CONSTANT(EXIT_BOUNCE);
+
+	BIND_ENUM_CONSTANT(RENDER_CANVAS_ITEMS);
+	BIND_ENUM_CONSTANT(RENDER_MULTIMESH);
+
+	BIND_ENUM_CONSTANT(MONITOR_LIVE_BULLETS);
+	BIND_ENUM_CONSTANT(MONITOR_SPAWNED);
+	BIND_ENUM_CONSTANT(MONITOR_RECYCLED);
+	BIND_ENUM_CONSTANT(MONITOR_POPPED_OUT_OF_BOUNDS);
+	BIND_ENUM_CONSTANT(MONITOR_POPPED_LIFETIME_SERVER);
+	BIND_ENUM_CONSTANT(MONITOR_POPPED_LIFETIME_BULLET);
+	BIND_ENUM_CONSTANT(MONITOR_POPPED_COLLIDE);
+	BIND_ENUM_CONSTANT(MONITOR_POPPED_REQUESTED);
+	BIND_ENUM_CONSTANT(MONITOR_POPPED_CANCELLED);
+	BIND_ENUM_CONSTANT(MONITOR_INTEGRATION_TIME);
+	BIND_ENUM_CONSTANT(MONITOR_COLLISION_TIME);
+	BIND_ENUM_CONSTANT(MONITOR_REPORT_TIME);
+	BIND_ENUM_CONSTANT(MONITOR_RENDER_TIME);
+	BIND_ENUM_CONSTANT(MONITOR_GOVERNOR_LEVEL);
+	BIND_ENUM_CONSTANT(MONITOR_MAX);
+
+	BIND_ENUM_CONSTANT(GOVERNOR_NONE);
+	BIND_ENUM_CONSTANT(GOVERNOR_STAGGER_COLLISIONS);
+	BIND_ENUM_CONSTANT(GOVERNOR_CULL_RENDER);
+	BIND_ENUM_CONSTANT(GOVERNOR_REFUSE_SPAWNS);
 }
 
 BulletServer::BulletServer() {
 	bullet_pool_size = 1500;
 	bullet_pool = nullptr;
 	live_bullet_count = 0;
+	_heap_dirty = false;
 	max_lifetime = 0.0;
 	max_collisions_per_bullet = 32;
+	sweep_collisions = true;
+	max_collision_substeps = 4;
 	play_area_allow_incoming = true;
 	play_area_mode = VIEWPORT;
+	play_area_exit_mode = EXIT_POP;
 	play_area_margin = 0;
 	play_area_rect = Rect2();
 	pop_on_collide = true;
 	relay_autoconnect = true;
+	cancel_pop = true;
+	_cancel_cell_size = CANCEL_MIN_CELL_SIZE;
+	_cancel_max_radius = 0.0;
+	_cancel_query_radius = 0.0;
+	_cancel_grid_dirty = true;
+	budget_msec = 0;
+	budget_recovery_ticks = 30;
+	budget_focus_group = StringName();
+	budget_focus_radius = 200;
+	render_culling = true;
+	render_cull_margin = 64;
+	render_interpolation = false;
+	render_mode = RENDER_CANVAS_ITEMS;
+	render_effect_pool_size = 1024;
+	deterministic = false;
+	sim_ticks_per_second = 0;
+	_sim_accumulator = 0.0;
+	_sim_frame_step = 0.0;
+	state_retention_ticks = 120;
+	_sim_clock = 0;
+	_state_pruned_tick = 0;
+	_governor_level = GOVERNOR_NONE;
+	_governor_calm_ticks = 0;
+	_governor_render_usec = 0;
+	_tick_count = 0;
+	_spawn_serial = 0;
+	_next_pattern_id = 0;
+	_target_positions_tick = 0;
+	_last_data_id = 0;
+	_wheel_tick = 0;
+	_wheel_tick_usec = 1000000 / 60;
+	_record_start_tick = 0;
+	_replay_pending = false;
+	_replay_start_tick = 0;
+	monitors_enabled = false;
+	_monitors_registered = false;
+	for (int i = 0; i < MONITOR_MAX; i++) {
+		_monitor_counters[i] = 0;
+		_monitor_values[i] = 0;
+	}
 }
 
 BulletServer::~BulletServer() {
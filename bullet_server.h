@@ -2,15 +2,21 @@
 #define BULLETSERVER_H
 
 #include "bullet.h"
+#include "bullet_atlas.h"
 #include "bullet_server_relay.h"
+#include "bullet_spawn_log.h"
+#include "bullet_type_table.h"
 #include "resource/bullet_path.h"
+#include "resource/bullet_pattern.h"
 #include "resource/bullet_texture.h"
+#include "resource/homing_bullet_path.h"
 
 #include "scene/main/node.h"
 #include "servers/physics_2d/physics_server_2d.h"
 
 #include "core/templates/vector.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 
 class BulletServer : public Node {
 	GDCLASS(BulletServer, Node);
@@ -22,35 +28,365 @@ public:
 		INFINITE,
 	};
 
+	enum ExitMode {
+		EXIT_POP,
+		EXIT_WRAP,
+		EXIT_BOUNCE,
+	};
+
+	enum RenderMode {
+		RENDER_CANVAS_ITEMS,
+		RENDER_MULTIMESH,
+	};
+
+	enum Monitor {
+		MONITOR_LIVE_BULLETS,
+		MONITOR_SPAWNED,
+		MONITOR_RECYCLED,
+		MONITOR_POPPED_OUT_OF_BOUNDS,
+		MONITOR_POPPED_LIFETIME_SERVER,
+		MONITOR_POPPED_LIFETIME_BULLET,
+		MONITOR_POPPED_COLLIDE,
+		MONITOR_POPPED_REQUESTED,
+		MONITOR_POPPED_CANCELLED,
+		MONITOR_INTEGRATION_TIME,
+		MONITOR_COLLISION_TIME,
+		MONITOR_REPORT_TIME,
+		MONITOR_RENDER_TIME,
+		MONITOR_GOVERNOR_LEVEL,
+		MONITOR_MAX,
+	};
+
+	enum GovernorLevel {
+		GOVERNOR_NONE,
+		GOVERNOR_STAGGER_COLLISIONS,
+		GOVERNOR_CULL_RENDER,
+		GOVERNOR_REFUSE_SPAWNS,
+	};
+
 private:
+	struct PatternRunner {
+		Ref<BulletPattern> pattern;
+		int id = 0;
+		Vector2 origin;
+		float rotation = 0.0;
+		Vector2 target;
+		uint32_t pc = 0;
+		int wait = 0;
+		float direction = 0.0;
+		float speed = 1.0;
+		float arc = 0.0;
+		float radius = 0.0;
+		int shots = 1;
+		// x is the first instruction of the loop body, y the passes left (0 repeats forever)
+		LocalVector<Vector2i> loops;
+	};
+
 	int bullet_pool_size;
 	int live_bullet_count;
 	Bullet** bullet_pool;
+	//set when a pop leaves a bullet older than its parent. the heap is rebuilt after each sweep and before spawning
+	bool _heap_dirty;
 
 	bool pop_on_collide;
 	float max_lifetime;
 	int max_collisions_per_bullet;
+	bool sweep_collisions;
+	int max_collision_substeps;
 
 	AreaMode play_area_mode;
 	Rect2 play_area_rect;
 	float play_area_margin;
 	bool play_area_allow_incoming;
+	ExitMode play_area_exit_mode;
 
 	bool relay_autoconnect;
 
+	bool cancel_pop;
+
+	bool monitors_enabled;
+	bool _monitors_registered;
+	//the ids monitors were registered under, so renaming the server can't orphan them
+	LocalVector<StringName> _monitor_ids;
+	uint64_t _monitor_counters[MONITOR_MAX];
+	double _monitor_values[MONITOR_MAX];
+
+	float budget_msec;
+	int budget_recovery_ticks;
+	StringName budget_focus_group;
+	float budget_focus_radius;
+
+	bool render_culling;
+	float render_cull_margin;
+	bool render_interpolation;
+	RenderMode render_mode;
+	int render_effect_pool_size;
+
+	bool deterministic;
+	int sim_ticks_per_second;
+	double _sim_accumulator;
+	double _sim_frame_step;
+
+	int state_retention_ticks;
+
+	uint64_t _sim_clock;
+	uint64_t _state_pruned_tick;
+	BulletTypeTable<Ref<BulletPath>> _state_paths;
+	BulletTypeTable<Ref<BulletTexture>> _state_textures;
+	BulletTypeTable<Dictionary> _state_data;
+	BulletTypeTable<Ref<BulletPattern>> _state_patterns;
+
+	//textures in use, registered on first spawn so per-bullet work reads a flat descriptor instead of the resource
+	struct BulletType {
+		Ref<BulletTexture> texture;
+		uint32_t users = 0;
+		uint32_t revision = 0;
+		RID shape_rid;
+		float shape_reach = 0.0;
+		uint32_t collision_mask = 0;
+		bool collision_detect_bodies = false;
+		bool collision_detect_areas = false;
+		uint32_t cancel_layer = 0;
+		uint32_t cancel_mask = 0;
+		float cancel_radius = 0.0;
+		//where the type is drawn from in multimesh render mode, -1 if it can't be batched
+		int batch = -1;
+		Ref<Texture2D> atlas_sprite;
+		Ref<Texture2D> atlas_effect_sprite;
+		Rect2 uv;
+		Size2 sprite_size;
+		Color modulate;
+		int draw_layer = 0;
+		//sprite sheet layout, with uv holding the first frame
+		int frames = 1;
+		int hframes = 1;
+		float fps = 0.0;
+		bool loop = true;
+		BulletTexture::AnimationStart start = BulletTexture::ANIMATION_START_FIXED;
+		int start_frame = 0;
+		//pop effect, batched in every render mode. effect_frames is 0 when it keeps the frame the bullet popped on
+		int effect_batch = -1;
+		Rect2 effect_uv;
+		Size2 effect_size;
+		int effect_frames = 0;
+		int effect_hframes = 1;
+		double effect_usec = 0.0;
+		bool effect_fade = true;
+		float effect_scale = 1.0;
+	};
+	LocalVector<BulletType> _types;
+	HashMap<const BulletTexture *, uint16_t> _type_ids;
+	LocalVector<uint16_t> _free_types;
+
+	//multimesh render mode draws every bullet of an atlas page, material and light mask with one canvas item.
+	//materials that don't map UV onto the atlas region draw from the sprite's own texture, with its start frame
+	//baked into the batch's mesh
+	static const int BATCH_INSTANCE_FLOATS = 16;
+	struct RenderBatch {
+		int layer = 0;
+		RID texture;
+		RID mesh;
+		RID material;
+		int light_mask = 1;
+		//own-texture batches keep their texture alive, atlas pages outlive every batch
+		Ref<Texture2D> sprite;
+		RID canvas_item;
+		RID multimesh;
+		int capacity = 0;
+		int count = 0;
+		int fill = 0;
+		int visible = 0;
+		//instances are written to plain memory, then copied once into the buffer handed to the RenderingServer
+		LocalVector<float> instances;
+		Vector<float> buffer;
+		float *write = nullptr;
+	};
+	BulletAtlas _atlas;
+	LocalVector<RenderBatch> _batches;
+	LocalVector<Bullet *> _render_queue;
+	LocalVector<uint32_t> _render_type_cursor;
+
+	//pop effects hold a use of their type, so its atlas region outlives the bullet
+	struct PopEffect {
+		uint16_t type_id = 0;
+		int frame = 0;
+		Transform2D transform;
+		uint64_t start = 0;
+	};
+	LocalVector<PopEffect> _effects;
+	LocalVector<uint32_t> _render_effect_queue;
+	//every bullet and batch canvas item is drawn under this one, so draw layers only order them among themselves
+	RID _render_root;
+	RID _batch_mesh;
+	HashMap<Rect2, RID> _batch_frame_meshes;
+	RID _batch_shader;
+	RID _batch_material;
+
+	//custom data shared by live bullets, and their typed payloads in one array per slot
+	BulletTypeTable<Dictionary> _custom_data;
+	uint32_t _last_data_id;
+	LocalVector<int32_t> _payload_ints;
+	LocalVector<float> _payload_floats;
+
+	GovernorLevel _governor_level;
+	int _governor_calm_ticks;
+	uint64_t _governor_render_usec;
+	uint64_t _tick_count;
+	uint32_t _spawn_serial;
+
+	LocalVector<PatternRunner> _patterns;
+	LocalVector<PatternRunner> _started_patterns;
+	int _next_pattern_id;
+
+	BulletSpawnLog _record_log;
+	uint64_t _record_start_tick;
+	BulletSpawnLog _replay_log;
+	BulletSpawnLog::Volley _replay_volley;
+	bool _replay_pending;
+	uint64_t _replay_start_tick;
+
+	LocalVector<Bullet*> _collision_queue;
+	LocalVector<Bullet*> _popped_queue;
+	LocalVector<Bullet*> _homing_queue;
+	LocalVector<Vector2> _area_positions;
+	LocalVector<uint8_t> _area_codes;
+
+	//volleys emitted natively by popping or timed bullets, spawned once the pop sweep is done
+	struct ChildSpawn {
+		Ref<BulletTexture> texture;
+		Vector2 position;
+		float rotation;
+		Dictionary custom_data;
+	};
+	LocalVector<ChildSpawn> _child_spawns;
+
+	//bullets other servers can cancel, bucketed by a hash of their grid cell. built at most once per tick,
+	//and shared by every server testing against this one
+	struct CancelEntry {
+		Vector2 position;
+		float radius;
+		uint32_t layer;
+		uint32_t bucket;
+		Bullet *bullet;
+	};
+	LocalVector<ObjectID> _cancel_servers;
+	LocalVector<CancelEntry> _cancel_entries;
+	LocalVector<CancelEntry> _cancel_grid;
+	LocalVector<uint32_t> _cancel_buckets;
+	float _cancel_cell_size;
+	float _cancel_max_radius;
+	//the largest radius the grid's cells were sized for other servers to query with
+	float _cancel_query_radius;
+	bool _cancel_grid_dirty;
+
+	//scheduled spawns wait in a hierarchical timing wheel. level 0 has a slot per physics tick, each level above
+	//covers WHEEL_SIZE slots of the one below, and entries cascade down a level as their time comes closer
+	static const int WHEEL_BITS = 6;
+	static const int WHEEL_SIZE = 1 << WHEEL_BITS;
+	static const int WHEEL_LEVELS = 4;
+	struct ScheduledSpawn {
+		uint64_t due;
+		Vector2 position;
+		Ref<BulletPath> path;
+		Ref<BulletTexture> texture;
+		Dictionary custom_data;
+	};
+	LocalVector<ScheduledSpawn> _scheduled;
+	LocalVector<uint32_t> _scheduled_free;
+	LocalVector<uint32_t> _wheel[WHEEL_LEVELS][WHEEL_SIZE];
+	LocalVector<uint32_t> _wheel_overflow;
+	uint64_t _wheel_tick;
+	uint64_t _wheel_tick_usec;
+
+	LocalVector<Vector2> _focus_positions;
+	HashMap<StringName, LocalVector<Vector2>> _target_positions;
+	HashMap<ObjectID, Vector2> _target_node_positions;
+	uint64_t _target_positions_tick;
+
+	void _tick(float delta);
 	void _process_bullets(float delta);
+	void _pop_bullet(int index);
+
+	void _spawn_bullet(const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data, float p_age = 0.0, float p_heading = 0.0, float p_speed = 1.0);
+
+	uint16_t _acquire_type(const Ref<BulletTexture> &p_texture, uint16_t p_hint);
+	void _release_type(uint16_t p_id);
+	void _refresh_type(uint32_t p_id);
+	void _clear_types();
+	void _set_bullet_type(Bullet *p_bullet, const Ref<BulletTexture> &p_texture);
+	bool _update_bullet_type(Bullet *p_bullet);
+	int _get_animation_frame(const BulletType &p_type, const Bullet *p_bullet) const;
+
+	int _get_batch(int p_layer, const RID &p_texture, const RID &p_mesh, const RID &p_material, int p_light_mask, const Ref<Texture2D> &p_sprite);
+	int _get_sprite_batch(const Ref<Texture2D> &p_sprite, const Size2 &p_sheet, int p_frame, int p_layer, const Ref<Material> &p_material, bool p_maps_atlas, int p_light_mask, Ref<Texture2D> &r_atlas_sprite, Rect2 &r_uv, Size2 &r_size);
+	RID _get_batch_mesh(const Rect2 &p_uv);
+	void _sort_batches();
+	void _free_batches();
+	void _start_pop_effect(Bullet *p_bullet);
+	void _expire_pop_effects();
+
+	void _advance_spawned_bullet(Bullet *p_bullet, float p_age);
+	void _queue_child_spawn(const Bullet *p_bullet);
+	void _spawn_children();
+
+	void _schedule_spawn(uint64_t p_due, const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data);
+	void _wheel_insert(uint32_t p_index);
+	void _wheel_cascade(int p_level);
+	void _expire_scheduled_spawns();
+	void _get_scheduled_entries(LocalVector<uint32_t> &r_entries) const;
+	void _rebuild_schedule();
+
+	Vector2 _get_bullet_step(Bullet *p_bullet, const Ref<BulletPath> &p_path, float p_delta);
+	Vector2 _get_impulse_step(Bullet *p_bullet, float p_delta);
+	void _step_bullet_program(Bullet *p_bullet);
+	const LocalVector<Vector2> &_get_target_positions(const StringName &p_group);
+	bool _get_target_node_position(ObjectID p_node, Vector2 &r_position);
+	bool _get_nearest_target(const StringName &p_group, const Vector2 &p_from, Vector2 &r_target);
+	void _steer_homing_bullets(float delta);
 
 	void _handle_collisions(Bullet* bullet, PhysicsDirectSpaceState2D* space_state, Dictionary out);
 
+	void _build_cancel_grid(float p_query_radius);
+	Bullet *_find_cancel_target(const Vector2 &p_position, float p_radius, uint32_t p_mask, const Bullet *p_exclude) const;
+	void _cancel_bullets(Array &r_cancelled);
+
 	void _init_bullets();
 	void _uninit_bullets();
 
 	void _free_bullet(int index);
 	void _heapify(int index);
+	void _heap_update(int index);
+	void _restore_heap();
 
 	void _update_play_area();
 
-	bool _bullet_trajectory_valid(const Vector2 &p_pos, const Vector2 &p_dir) const;
+	bool _bullet_trajectory_valid(const Vector2 &p_pos, const Vector2 &p_dir, int p_out_code) const;
+	void _classify_play_area();
+	void _emit_timed_volleys();
+	void _wrap_bullet(Bullet *p_bullet);
+	void _bounce_bullet(Bullet *p_bullet, int p_out_code);
+
+	void _update_governor(uint64_t p_tick_usec);
+	void _update_focus_positions();
+	bool _should_stagger_collision(const Bullet *p_bullet) const;
+	Rect2 _get_view_rect() const;
+	void _sync_render();
+	int _sync_batches(bool p_culling, const Rect2 &p_view_rect, float p_fraction);
+	float _get_interpolation_fraction() const;
+	int _get_ticks_per_second() const;
+
+	void _replay_spawns();
+
+	void _run_patterns();
+	bool _step_pattern(PatternRunner &r_runner);
+	void _fire_pattern(const PatternRunner &p_runner);
+	PatternRunner *_get_pattern_runner(int p_id);
+
+	bool _decode_state_delta(const PackedByteArray &p_reference, const PackedByteArray &p_delta, PackedByteArray &r_state) const;
+
+	void _register_monitors();
+	void _unregister_monitors();
+	void _publish_monitors();
 
 protected:
 	static void _bind_methods();
@@ -64,9 +400,37 @@ public:
 	void spawn_bullet(const Vector2 &p_position, const Ref<BulletPath> &p_path,  const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data = Dictionary());
 	void spawn_volley(const Vector2 &p_position, const Array &p_volley, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data = Dictionary());
 
+	void schedule_spawn(float p_delay, const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data = Dictionary());
+	void schedule_volley(float p_delay, const Vector2 &p_position, const Array &p_volley, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data = Dictionary());
+	int get_scheduled_spawn_count() const;
+	void clear_scheduled_spawns();
+
 	void clear_bullets();
 	int get_live_bullet_count();
 
+	double get_sim_time() const;
+
+	PackedByteArray save_state();
+	Error load_state(const PackedByteArray &p_state);
+	PackedByteArray save_state_delta(const PackedByteArray &p_reference);
+	Error load_state_delta(const PackedByteArray &p_reference, const PackedByteArray &p_delta);
+
+	int run_pattern(const Ref<BulletPattern> &p_pattern, const Vector2 &p_origin, float p_rotation = 0.0, const Vector2 &p_target = Vector2());
+	void stop_pattern(int p_id);
+	void stop_all_patterns();
+	bool is_pattern_running(int p_id) const;
+	void set_pattern_origin(int p_id, const Vector2 &p_origin, float p_rotation);
+	void set_pattern_target(int p_id, const Vector2 &p_target);
+
+	Error start_recording(const String &p_path);
+	void stop_recording();
+	bool is_recording() const;
+
+	Error start_replay(const String &p_path);
+	int replay_ticks(int p_ticks = -1);
+	void stop_replay();
+	bool is_replaying() const;
+
 	Array get_live_bullets();
 	Array get_live_bullet_positions();
 
@@ -82,6 +446,12 @@ public:
 	void set_max_collisions_per_bullet(int p_count);
 	int get_max_collisions_per_bullet() const;
 
+	void set_sweep_collisions(bool p_enabled);
+	bool get_sweep_collisions() const;
+
+	void set_max_collision_substeps(int p_substeps);
+	int get_max_collision_substeps() const;
+
 	void set_play_area_mode(AreaMode p_mode);
 	AreaMode get_play_area_mode() const;
 
@@ -94,10 +464,69 @@ public:
 	void set_play_area_allow_incoming(bool p_enabled);
 	bool get_play_area_allow_incoming() const;
 
+	void set_play_area_exit_mode(ExitMode p_mode);
+	ExitMode get_play_area_exit_mode() const;
+
 	void set_relay_autoconnect(bool p_enabled);
 	bool get_relay_autoconnect() const;
+
+	void add_cancel_server(BulletServer *p_server);
+	void remove_cancel_server(BulletServer *p_server);
+	void clear_cancel_servers();
+	Array get_cancel_servers() const;
+
+	void set_cancel_pop(bool p_enabled);
+	bool get_cancel_pop() const;
+
+	void set_deterministic(bool p_enabled);
+	bool get_deterministic() const;
+
+	void set_sim_ticks_per_second(int p_ticks);
+	int get_sim_ticks_per_second() const;
+
+	void set_state_retention_ticks(int p_ticks);
+	int get_state_retention_ticks() const;
+
+	void set_monitors_enabled(bool p_enabled);
+	bool get_monitors_enabled() const;
+
+	double get_monitor(Monitor p_monitor) const;
+
+	void set_budget_msec(float p_msec);
+	float get_budget_msec() const;
+
+	void set_budget_recovery_ticks(int p_ticks);
+	int get_budget_recovery_ticks() const;
+
+	void set_budget_focus_group(const StringName &p_group);
+	StringName get_budget_focus_group() const;
+
+	void set_budget_focus_radius(float p_radius);
+	float get_budget_focus_radius() const;
+
+	void set_render_culling(bool p_enabled);
+	bool get_render_culling() const;
+
+	void set_render_cull_margin(float p_margin);
+	float get_render_cull_margin() const;
+
+	void set_render_interpolation(bool p_enabled);
+	bool get_render_interpolation() const;
+
+	void set_render_mode(RenderMode p_mode);
+	RenderMode get_render_mode() const;
+
+	void set_render_effect_pool_size(int p_size);
+	int get_render_effect_pool_size() const;
+	int get_live_effect_count() const;
+
+	GovernorLevel get_governor_level() const;
 };
 
 VARIANT_ENUM_CAST(BulletServer::AreaMode)
+VARIANT_ENUM_CAST(BulletServer::ExitMode)
+VARIANT_ENUM_CAST(BulletServer::RenderMode)
+VARIANT_ENUM_CAST(BulletServer::Monitor)
+VARIANT_ENUM_CAST(BulletServer::GovernorLevel)
 
 #endif
@@ -0,0 +1,492 @@
+#include "bullet_spawn_log.h"
+
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/object/class_db.h"
+
+#define VOLLEY_RECORD_SIZE 19
+#define SHOT_RECORD_SIZE 15
+#define DEFINE_RECORD_SIZE 8
+//deep enough for any sensible chain of emit textures and nested paths
+#define MAX_EMBED_DEPTH 16
+
+//embedded resources can only be rebuilt as one of these, all of which hold plain data and run no code of their own
+static const char *embeddable_classes[] = { "BulletPath", "BulletTexture", "BulletProgram", "Curve", "Curve2D", "Shape2D" };
+
+bool BulletSpawnLog::_is_embeddable(const StringName &p_class) {
+	for (const char *base : embeddable_classes) {
+		if (ClassDB::is_parent_class(p_class, base)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BulletSpawnLog::_is_embedded_property(const PropertyInfo &p_property) {
+	return (p_property.usage & PROPERTY_USAGE_STORAGE) && p_property.name != "script" && !p_property.name.begins_with("resource_") && !p_property.name.begins_with("metadata/");
+}
+
+bool BulletSpawnLog::_embed_value(const Variant &p_value, int p_depth, Variant &r_embedded) {
+	ERR_FAIL_COND_V(p_depth > MAX_EMBED_DEPTH, false);
+	switch (p_value.get_type()) {
+		case Variant::OBJECT: {
+			Ref<Resource> resource = p_value;
+			if (resource.is_null()) {
+				r_embedded = Variant();
+				return p_value.get_validated_object() == nullptr;
+			}
+			if (resource->get_path().is_resource_file()) {
+				Dictionary file;
+				file["@path"] = resource->get_path();
+				r_embedded = file;
+				return true;
+			}
+			if (!_is_embeddable(resource->get_class_name()) || !resource->get_script().is_null()) {
+				return false;
+			}
+			Dictionary properties;
+			List<PropertyInfo> list;
+			resource->get_property_list(&list);
+			for (const PropertyInfo &E : list) {
+				if (!_is_embedded_property(E)) {
+					continue;
+				}
+				Variant value;
+				if (!_embed_value(resource->get(E.name), p_depth + 1, value)) {
+					return false;
+				}
+				properties[E.name] = value;
+			}
+			Dictionary embedded;
+			embedded["@class"] = resource->get_class_name();
+			embedded["@properties"] = properties;
+			r_embedded = embedded;
+			return true;
+		}
+		case Variant::ARRAY: {
+			Array source = p_value;
+			Array array;
+			for (int i = 0; i < source.size(); i++) {
+				Variant value;
+				if (!_embed_value(source[i], p_depth + 1, value)) {
+					return false;
+				}
+				array.push_back(value);
+			}
+			r_embedded = array;
+			return true;
+		}
+		case Variant::DICTIONARY: {
+			Dictionary source = p_value;
+			Dictionary dictionary;
+			Array keys = source.keys();
+			for (int i = 0; i < keys.size(); i++) {
+				Variant value;
+				if (!_embed_value(source[keys[i]], p_depth + 1, value)) {
+					return false;
+				}
+				dictionary[keys[i]] = value;
+			}
+			r_embedded = dictionary;
+			return true;
+		}
+		default: {
+			r_embedded = p_value;
+			return true;
+		}
+	}
+}
+
+Variant BulletSpawnLog::_restore_value(const Variant &p_value, int p_depth, bool &r_valid) {
+	if (p_depth > MAX_EMBED_DEPTH) {
+		r_valid = false;
+		return Variant();
+	}
+	if (p_value.get_type() == Variant::ARRAY) {
+		Array source = p_value;
+		Array array;
+		for (int i = 0; i < source.size(); i++) {
+			array.push_back(_restore_value(source[i], p_depth + 1, r_valid));
+		}
+		return array;
+	}
+	if (p_value.get_type() != Variant::DICTIONARY) {
+		return p_value;
+	}
+
+	Dictionary source = p_value;
+	if (source.size() == 1 && source.has("@path")) {
+		//the type is checked before loading, so a log can't make scripts load
+		String path = source["@path"];
+		String type = ResourceLoader::get_resource_type(path);
+		if (!path.is_resource_file() || type.is_empty() || ClassDB::is_parent_class(type, "Script")) {
+			r_valid = false;
+			return Variant();
+		}
+		return ResourceLoader::load(path, type);
+	}
+	if (source.size() == 2 && source.has("@class") && source.has("@properties")) {
+		StringName class_name = source["@class"];
+		if (!_is_embeddable(class_name) || !ClassDB::can_instantiate(class_name)) {
+			r_valid = false;
+			return Variant();
+		}
+		Ref<Resource> resource = Object::cast_to<Resource>(ClassDB::instantiate(class_name));
+		Dictionary properties = source["@properties"];
+		List<PropertyInfo> list;
+		resource->get_property_list(&list);
+		for (const PropertyInfo &E : list) {
+			if (_is_embedded_property(E) && properties.has(E.name)) {
+				resource->set(E.name, _restore_value(properties[E.name], p_depth + 1, r_valid));
+			}
+		}
+		return resource;
+	}
+
+	Dictionary dictionary;
+	Array keys = source.keys();
+	for (int i = 0; i < keys.size(); i++) {
+		dictionary[keys[i]] = _restore_value(source[keys[i]], p_depth + 1, r_valid);
+	}
+	return dictionary;
+}
+
+uint16_t BulletSpawnLog::_define_resource(DefineKind p_kind, const Ref<Resource> &p_resource) {
+	if (p_resource.is_null()) {
+		return 0;
+	}
+	const uint16_t *existing = written_ids[p_kind].getptr(p_resource.ptr());
+	if (existing) {
+		return *existing;
+	}
+	ERR_FAIL_COND_V_MSG(written_ids[p_kind].size() >= UINT16_MAX, 0, vformat("BulletSpawnLog: too many distinct resources to record, %d spawns were dropped from the log.", ++dropped_spawns));
+
+	uint16_t id = written_ids[p_kind].size() + 1;
+	String path = p_resource->get_path();
+	if (path.is_resource_file()) {
+		CharString utf8 = path.utf8();
+		_write_define(p_kind, id, (const uint8_t *)utf8.get_data(), utf8.length());
+	} else {
+		//resources without a file of their own, like built-in sub-resources and copies made at runtime, are written out
+		//as their class and properties
+		Variant embedded;
+		int length = 0;
+		bool embeddable = _embed_value(p_resource, 0, embedded) && encode_variant(embedded, nullptr, length) == OK;
+		ERR_FAIL_COND_V_MSG(!embeddable, 0, vformat("BulletSpawnLog: %s has no file of its own and can't be embedded in the log, because it, or a sub-resource without a file, is scripted or not plain bullet data. %d spawns were dropped from the log.", p_resource->get_class_name(), ++dropped_spawns));
+		LocalVector<uint8_t> bytes;
+		bytes.resize(length);
+		encode_variant(embedded, bytes.ptr(), length);
+		_write_define(DefineKind(p_kind | DEFINE_EMBEDDED), id, bytes.ptr(), length);
+	}
+	written_ids[p_kind].insert(p_resource.ptr(), id);
+	written_resources.push_back(p_resource);
+	return id;
+}
+
+uint16_t BulletSpawnLog::_define_data(const Dictionary &p_data) {
+	if (p_data.is_empty()) {
+		return 0;
+	}
+	const uint16_t *existing = written_ids[DEFINE_DATA].getptr(p_data.id());
+	if (existing) {
+		return *existing;
+	}
+	ERR_FAIL_COND_V_MSG(written_ids[DEFINE_DATA].size() >= UINT16_MAX, 0, "BulletSpawnLog: too many distinct custom data dictionaries to record.");
+
+	int length = 0;
+	ERR_FAIL_COND_V(encode_variant(p_data, nullptr, length) != OK, 0);
+	LocalVector<uint8_t> bytes;
+	bytes.resize(length);
+	encode_variant(p_data, bytes.ptr(), length);
+
+	uint16_t id = written_ids[DEFINE_DATA].size() + 1;
+	_write_define(DEFINE_DATA, id, bytes.ptr(), length);
+	written_ids[DEFINE_DATA].insert(p_data.id(), id);
+	written_data.push_back(p_data);
+	return id;
+}
+
+void BulletSpawnLog::_write_define(DefineKind p_kind, uint16_t p_id, const uint8_t *p_bytes, uint32_t p_length) {
+	file->store_8(RECORD_DEFINE);
+	file->store_8(p_kind);
+	file->store_16(p_id);
+	file->store_32(p_length);
+	file->store_buffer(p_bytes, p_length);
+}
+
+void BulletSpawnLog::_write_shot(const Vector2 &p_position, const Ref<BulletPath> &p_path, uint8_t p_volley_flags, float p_age, float p_heading, float p_speed) {
+	uint16_t path_id = 0;
+	uint8_t flags = 0;
+	//a heading is replayed as a rotated copy of the path, which moves the bullet the same way
+	float rotation = p_heading;
+	if (p_path.is_valid() && p_path->get_rotation_source().is_valid()) {
+		path_id = _define_resource(DEFINE_PATH, p_path->get_rotation_source());
+		flags |= SHOT_ROTATED;
+		rotation += p_path->get_source_rotation();
+	} else {
+		path_id = _define_resource(DEFINE_PATH, p_path);
+		if (rotation != 0.0) {
+			flags |= SHOT_ROTATED;
+		}
+	}
+	file->store_float(p_position.x);
+	file->store_float(p_position.y);
+	file->store_16(path_id);
+	file->store_8(flags);
+	file->store_float(rotation);
+	if (p_volley_flags & VOLLEY_AGED) {
+		file->store_float(p_age);
+	}
+	if (p_volley_flags & VOLLEY_SPEED) {
+		file->store_float(p_speed);
+	}
+}
+
+Error BulletSpawnLog::open_write(const String &p_path, uint32_t p_ticks_per_second) {
+	close();
+	Error err;
+	file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Cannot open spawn log '%s' for writing.", p_path));
+	writing = true;
+	ticks_per_second = p_ticks_per_second;
+
+	file->store_32(MAGIC);
+	file->store_16(VERSION);
+	file->store_16(0);
+	file->store_32(ticks_per_second);
+	return OK;
+}
+
+void BulletSpawnLog::write_bullet(uint32_t p_tick, const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data, float p_age, float p_heading, float p_speed) {
+	ERR_FAIL_COND(!is_writing());
+	//definitions must precede the volley that uses them
+	uint16_t texture_id = _define_resource(DEFINE_TEXTURE, p_texture);
+	uint16_t data_id = _define_data(p_custom_data);
+	if (p_path.is_valid() && p_path->get_rotation_source().is_valid()) {
+		_define_resource(DEFINE_PATH, p_path->get_rotation_source());
+	} else {
+		_define_resource(DEFINE_PATH, p_path);
+	}
+
+	uint8_t volley_flags = (p_age > 0.0 ? VOLLEY_AGED : 0) | (p_speed != 1.0 ? VOLLEY_SPEED : 0);
+	file->store_8(RECORD_VOLLEY);
+	file->store_8(volley_flags);
+	file->store_16(texture_id);
+	file->store_32(p_tick);
+	file->store_float(p_position.x);
+	file->store_float(p_position.y);
+	file->store_16(data_id);
+	file->store_16(1);
+	_write_shot(Vector2(), p_path, volley_flags, p_age, p_heading, p_speed);
+}
+
+void BulletSpawnLog::write_volley(uint32_t p_tick, const Vector2 &p_origin, const Array &p_volley, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data) {
+	ERR_FAIL_COND(!is_writing());
+	ERR_FAIL_COND_MSG(p_volley.size() > UINT16_MAX, "BulletSpawnLog: volley has too many shots to record.");
+	uint16_t texture_id = _define_resource(DEFINE_TEXTURE, p_texture);
+	uint16_t data_id = _define_data(p_custom_data);
+	uint8_t volley_flags = 0;
+	for (int i = 0; i < p_volley.size(); i++) {
+		Dictionary shot = p_volley[i];
+		if (float(shot.get("age", 0.0)) > 0.0) {
+			volley_flags |= VOLLEY_AGED;
+		}
+		if (float(shot.get("speed", 1.0)) != 1.0) {
+			volley_flags |= VOLLEY_SPEED;
+		}
+		Ref<BulletPath> path = shot["path"];
+		if (path.is_valid() && path->get_rotation_source().is_valid()) {
+			_define_resource(DEFINE_PATH, path->get_rotation_source());
+		} else {
+			_define_resource(DEFINE_PATH, path);
+		}
+	}
+
+	file->store_8(RECORD_VOLLEY);
+	file->store_8(volley_flags);
+	file->store_16(texture_id);
+	file->store_32(p_tick);
+	file->store_float(p_origin.x);
+	file->store_float(p_origin.y);
+	file->store_16(data_id);
+	file->store_16(p_volley.size());
+	for (int i = 0; i < p_volley.size(); i++) {
+		Dictionary shot = p_volley[i];
+		_write_shot(shot["position"], shot["path"], volley_flags, shot.get("age", 0.0), 0.0, shot.get("speed", 1.0));
+	}
+}
+
+Error BulletSpawnLog::open_read(const String &p_path) {
+	close();
+	Error err;
+	file = FileAccess::open(p_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Cannot open spawn log '%s' for reading.", p_path));
+	writing = false;
+
+	if (file->get_length() < 12 || file->get_32() != MAGIC) {
+		close();
+		ERR_FAIL_V_MSG(ERR_FILE_UNRECOGNIZED, vformat("'%s' is not a bullet spawn log.", p_path));
+	}
+	uint16_t version = file->get_16();
+	file->get_16();
+	if (version > VERSION) {
+		close();
+		ERR_FAIL_V_MSG(ERR_FILE_UNRECOGNIZED, vformat("Spawn log '%s' was written by a newer version (%d).", p_path, version));
+	}
+	ticks_per_second = file->get_32();
+
+	read_paths.resize(1);
+	read_textures.resize(1);
+	read_data.resize(1);
+	return OK;
+}
+
+Ref<Resource> BulletSpawnLog::_decode_resource(const LocalVector<uint8_t> &p_bytes) {
+	Variant embedded;
+	if (decode_variant(embedded, p_bytes.ptr(), p_bytes.size()) != OK || embedded.get_type() != Variant::DICTIONARY) {
+		return Ref<Resource>();
+	}
+	bool valid = true;
+	Ref<Resource> resource = _restore_value(embedded, 0, valid);
+	return valid ? resource : Ref<Resource>();
+}
+
+bool BulletSpawnLog::_read_define() {
+	uint8_t kind = file->get_8();
+	uint16_t id = file->get_16();
+	uint32_t length = file->get_32();
+	bool embedded = kind & DEFINE_EMBEDDED;
+	kind &= ~DEFINE_EMBEDDED;
+	ERR_FAIL_COND_V_MSG(kind > DEFINE_DATA || (embedded && kind == DEFINE_DATA), false, "Spawn log contains an unknown definition.");
+	if (file->get_length() - file->get_position() < length) {
+		return false;
+	}
+	LocalVector<uint8_t> bytes;
+	bytes.resize(length);
+	file->get_buffer(bytes.ptr(), length);
+
+	switch (kind) {
+		case DEFINE_PATH: {
+			if (read_paths.size() <= id) {
+				read_paths.resize(id + 1);
+			}
+			if (embedded) {
+				read_paths[id] = _decode_resource(bytes);
+				ERR_FAIL_COND_V_MSG(read_paths[id].is_null(), true, "Spawn log contains an embedded path that could not be decoded.");
+				break;
+			}
+			String path = String::utf8((const char *)bytes.ptr(), length);
+			if (ClassDB::is_parent_class(ResourceLoader::get_resource_type(path), "BulletPath")) {
+				read_paths[id] = ResourceLoader::load(path, "BulletPath");
+			}
+			ERR_FAIL_COND_V_MSG(read_paths[id].is_null(), true, vformat("Spawn log references path '%s', which could not be loaded.", path));
+		} break;
+		case DEFINE_TEXTURE: {
+			if (read_textures.size() <= id) {
+				read_textures.resize(id + 1);
+			}
+			if (embedded) {
+				read_textures[id] = _decode_resource(bytes);
+				ERR_FAIL_COND_V_MSG(read_textures[id].is_null(), true, "Spawn log contains an embedded texture that could not be decoded.");
+				break;
+			}
+			String path = String::utf8((const char *)bytes.ptr(), length);
+			if (ClassDB::is_parent_class(ResourceLoader::get_resource_type(path), "BulletTexture")) {
+				read_textures[id] = ResourceLoader::load(path, "BulletTexture");
+			}
+			ERR_FAIL_COND_V_MSG(read_textures[id].is_null(), true, vformat("Spawn log references texture '%s', which could not be loaded.", path));
+		} break;
+		case DEFINE_DATA: {
+			if (read_data.size() <= id) {
+				read_data.resize(id + 1);
+			}
+			Variant data;
+			ERR_FAIL_COND_V_MSG(decode_variant(data, bytes.ptr(), length) != OK, true, "Spawn log contains custom data that could not be decoded.");
+			read_data[id] = data;
+		} break;
+	}
+	return true;
+}
+
+bool BulletSpawnLog::read_volley(Volley &r_volley) {
+	ERR_FAIL_COND_V(!is_open() || writing, false);
+
+	//a log that is still being written, or was cut short by a crash, ends at the last complete record
+	while (file->get_length() - file->get_position() >= DEFINE_RECORD_SIZE) {
+		uint8_t type = file->get_8();
+		if (type == RECORD_DEFINE) {
+			if (!_read_define()) {
+				return false;
+			}
+			continue;
+		}
+		ERR_FAIL_COND_V_MSG(type != RECORD_VOLLEY, false, "Spawn log is corrupt.");
+		if (file->get_length() - file->get_position() < VOLLEY_RECORD_SIZE - 1) {
+			return false;
+		}
+
+		uint8_t volley_flags = file->get_8();
+		uint64_t shot_size = SHOT_RECORD_SIZE + ((volley_flags & VOLLEY_AGED) ? 4 : 0) + ((volley_flags & VOLLEY_SPEED) ? 4 : 0);
+		uint16_t texture_id = file->get_16();
+		r_volley.tick = file->get_32();
+		r_volley.origin.x = file->get_float();
+		r_volley.origin.y = file->get_float();
+		uint16_t data_id = file->get_16();
+		uint16_t shot_count = file->get_16();
+		if (file->get_length() - file->get_position() < shot_count * shot_size) {
+			return false;
+		}
+
+		r_volley.texture = texture_id < read_textures.size() ? read_textures[texture_id] : Ref<BulletTexture>();
+		r_volley.custom_data = data_id < read_data.size() ? read_data[data_id] : Dictionary();
+		r_volley.shots = Array();
+		for (int i = 0; i < shot_count; i++) {
+			Vector2 position;
+			position.x = file->get_float();
+			position.y = file->get_float();
+			uint16_t path_id = file->get_16();
+			uint8_t flags = file->get_8();
+			float rotation = file->get_float();
+			float age = (volley_flags & VOLLEY_AGED) ? file->get_float() : 0.0;
+			float speed = (volley_flags & VOLLEY_SPEED) ? file->get_float() : 1.0;
+
+			Ref<BulletPath> path = path_id < read_paths.size() ? read_paths[path_id] : Ref<BulletPath>();
+			if (path.is_null()) {
+				continue;
+			}
+			Dictionary shot;
+			shot["position"] = position;
+			shot["path"] = (flags & SHOT_ROTATED) ? path->rotated(rotation) : path;
+			if (age > 0.0) {
+				shot["age"] = age;
+			}
+			if (speed != 1.0) {
+				shot["speed"] = speed;
+			}
+			r_volley.shots.push_back(shot);
+		}
+		return true;
+	}
+	return false;
+}
+
+void BulletSpawnLog::close() {
+	if (file.is_valid() && writing) {
+		file->flush();
+	}
+	file.unref();
+	writing = false;
+	for (int i = 0; i < 3; i++) {
+		written_ids[i].clear();
+	}
+	written_resources.clear();
+	written_data.clear();
+	dropped_spawns = 0;
+	read_paths.clear();
+	read_textures.clear();
+	read_data.clear();
+}
+
+BulletSpawnLog::~BulletSpawnLog() {
+	close();
+}
@@ -0,0 +1,110 @@
+#ifndef BULLETSPAWNLOG_H
+#define BULLETSPAWNLOG_H
+
+#include "resource/bullet_path.h"
+#include "resource/bullet_texture.h"
+
+#include "core/io/file_access.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/array.h"
+#include "core/variant/dictionary.h"
+
+// Append-only binary log of spawn calls. Everything is little-endian and
+// byte-packed with no pointers or offsets, so a log can be streamed, appended
+// to while open, or mapped and walked in place.
+//
+//   header: magic u32, version u16, reserved u16, ticks_per_second u32
+//   define: RECORD_DEFINE u8, kind u8, id u16, length u32, utf8 resource path (or encoded custom data,
+//           or the encoded class name and properties of the resource if kind has DEFINE_EMBEDDED set)
+//   volley: RECORD_VOLLEY u8, volley flags u8, texture id u16, tick u32, origin f32 x2, data id u16, shot count u16,
+//           then per shot: position f32 x2, path id u16, flags u8, rotation f32, age f32 if the volley is VOLLEY_AGED,
+//           and speed f32 if the volley is VOLLEY_SPEED
+//
+// Paths and textures are written once as resource paths and then referred to
+// by id. Ones that aren't saved to a file of their own are embedded instead,
+// as their class name and stored properties. Logs never hold encoded objects,
+// and only a short list of plain data classes can be rebuilt from one.
+// Rotated copies made by spawners, and bullets spawned with a heading, are
+// logged as their source path plus the rotation, so a volley costs 15 bytes
+// per shot.
+class BulletSpawnLog {
+public:
+	enum DefineKind {
+		DEFINE_PATH,
+		DEFINE_TEXTURE,
+		DEFINE_DATA,
+		DEFINE_EMBEDDED = 0x80,
+	};
+
+	struct Volley {
+		uint32_t tick = 0;
+		Vector2 origin;
+		Ref<BulletTexture> texture;
+		Dictionary custom_data;
+		Array shots;
+	};
+
+private:
+	enum RecordType {
+		RECORD_DEFINE = 1,
+		RECORD_VOLLEY = 2,
+	};
+
+	enum VolleyFlags {
+		VOLLEY_AGED = 1,
+		VOLLEY_SPEED = 2,
+	};
+
+	enum ShotFlags {
+		SHOT_ROTATED = 1,
+	};
+
+	Ref<FileAccess> file;
+	bool writing = false;
+	uint32_t ticks_per_second = 0;
+
+	// writer side: resources are kept referenced so their ids can't be reused by a new object at the same address
+	HashMap<const void *, uint16_t> written_ids[3];
+	LocalVector<Ref<Resource>> written_resources;
+	LocalVector<Dictionary> written_data;
+	uint32_t dropped_spawns = 0;
+
+	// reader side, indexed by id, with 0 meaning "none"
+	LocalVector<Ref<BulletPath>> read_paths;
+	LocalVector<Ref<BulletTexture>> read_textures;
+	LocalVector<Dictionary> read_data;
+
+	uint16_t _define_resource(DefineKind p_kind, const Ref<Resource> &p_resource);
+	uint16_t _define_data(const Dictionary &p_data);
+	void _write_define(DefineKind p_kind, uint16_t p_id, const uint8_t *p_bytes, uint32_t p_length);
+	void _write_shot(const Vector2 &p_position, const Ref<BulletPath> &p_path, uint8_t p_volley_flags, float p_age, float p_heading, float p_speed);
+
+	static bool _is_embeddable(const StringName &p_class);
+	static bool _is_embedded_property(const PropertyInfo &p_property);
+	static bool _embed_value(const Variant &p_value, int p_depth, Variant &r_embedded);
+	static Variant _restore_value(const Variant &p_value, int p_depth, bool &r_valid);
+	static Ref<Resource> _decode_resource(const LocalVector<uint8_t> &p_bytes);
+	bool _read_define();
+
+public:
+	static const uint32_t MAGIC = 0x4C534251;
+	static const uint16_t VERSION = 5;
+
+	bool is_open() const { return file.is_valid(); }
+	bool is_writing() const { return file.is_valid() && writing; }
+	uint32_t get_ticks_per_second() const { return ticks_per_second; }
+
+	Error open_write(const String &p_path, uint32_t p_ticks_per_second);
+	void write_bullet(uint32_t p_tick, const Vector2 &p_position, const Ref<BulletPath> &p_path, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data, float p_age = 0.0, float p_heading = 0.0, float p_speed = 1.0);
+	void write_volley(uint32_t p_tick, const Vector2 &p_origin, const Array &p_volley, const Ref<BulletTexture> &p_texture, const Dictionary &p_custom_data);
+
+	Error open_read(const String &p_path);
+	bool read_volley(Volley &r_volley);
+
+	void close();
+
+	~BulletSpawnLog();
+};
+
+#endif
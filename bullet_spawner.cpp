@@ -1,5 +1,22 @@
 #include "bullet_spawner.h"
 
+#include "bullet_server.h"
+#include "bullet_tracer.h"
+
+#include "core/io/marshalls.h"
+
+// Volley events carry everything that shapes a volley except the path, texture and custom data,
+// which peers are expected to share through the scene.
+//   version u8, flags u8, aim_mode u8, scatter_mode u8, tick u32, scatter rng state u64,
+//   origin f32 x2, rotation f32, scale f32 x2, shot_count u16, index count u16,
+//   radius, arc_width, arc_rotation, arc_offset, aim_angle, aim_target x/y, scatter_range f32,
+//   then the fired shot indices as u16
+#define VOLLEY_EVENT_VERSION 1
+#define VOLLEY_EVENT_SIZE 72
+#define VOLLEY_EVENT_HAS_INDICES 1
+//events come from other peers, so their volleys are bounded before anything is built from them
+#define VOLLEY_EVENT_MAX_SHOTS 4096
+
 //"overrides"
 void BulletSpawner::_notification(int p_what) {
 	switch (p_what) {
@@ -13,6 +30,9 @@ void BulletSpawner::_notification(int p_what) {
 				BulletServerRelay *relay = Object::cast_to<BulletServerRelay>(Engine::get_singleton()->get_singleton_object("BulletServerRelay"));
 				connect("volley_fired", Callable(relay, "spawn_volley"));
 			}
+			if (!deterministic) {
+				_scatter_rng.randomize();
+			}
 			set_physics_process(true);
 			set_visible(preview_visible_in_game);
 		} break;
@@ -21,7 +41,14 @@ void BulletSpawner::_notification(int p_what) {
 			if (Engine::get_singleton()->is_editor_hint()) {
 				return;
 			}
-			if (autofire) {
+			if (autofire && deterministic) {
+				//counting ticks rather than accumulating time keeps the firing schedule exact
+				_autofire_frames++;
+				if (_autofire_frames >= interval_frames) {
+					fire();
+					_autofire_frames = 0;
+				}
+			} else if (autofire) {
 				_autofire_time += get_physics_process_delta_time();
 				if (_autofire_time >= interval_frames / ProjectSettings::get_singleton()->get("physics/common/physics_ticks_per_second").operator float()) {
 					fire();
@@ -61,28 +88,188 @@ void BulletSpawner::fire() {
 	if (!can_fire()) {
 		return;
 	}
+	uint64_t trace_start = BulletTracer::get_singleton()->begin_span();
+	Array volley;
 	switch (pattern_mode) {
 		case ALL: {
-			emit_signal("volley_fired", get_global_position(), get_scattered_volley(), 
-					bullet_texture, custom_bullet_data);
+			volley = get_scattered_volley();
 		} break;
 
 		case MANUAL: {
-			emit_signal("volley_fired", get_global_position(), 
-					_get_selected_shots(get_scattered_volley(), active_shot_indices), bullet_texture, 
-					custom_bullet_data);
+			volley = _get_selected_shots(get_scattered_volley(), active_shot_indices);
 		} break;
 
 		default:
 			break;
 	}
+	//the span covers both building the volley and the server spawning it through the relay
+	emit_signal("volley_fired", get_global_position(), volley, bullet_texture, custom_bullet_data);
+	BulletTracer::get_singleton()->end_span("fire", this, trace_start, volley.size());
 }
 
 void BulletSpawner::fire_shots(const PackedInt32Array &p_shot_indices) {
 	if (!can_fire()) {
 		return;
 	}
-	emit_signal("volley_fired", bullet_path, get_global_position(), _get_selected_shots(get_scattered_volley(), p_shot_indices), bullet_texture, custom_bullet_data);
+	emit_signal("volley_fired", get_global_position(), _get_selected_shots(get_scattered_volley(), p_shot_indices), bullet_texture, custom_bullet_data);
+}
+
+PackedByteArray BulletSpawner::fire_event(int p_tick, const PackedInt32Array &p_shot_indices) {
+	PackedByteArray event;
+	ERR_FAIL_COND_V_MSG(shot_count > VOLLEY_EVENT_MAX_SHOTS, event, vformat("Volley events can't describe volleys of more than %d shots.", VOLLEY_EVENT_MAX_SHOTS));
+	if (!can_fire()) {
+		return event;
+	}
+	PackedInt32Array indices = p_shot_indices;
+	if (indices.is_empty() && pattern_mode == MANUAL) {
+		indices = active_shot_indices;
+	}
+	uint8_t flags = (!p_shot_indices.is_empty() || pattern_mode == MANUAL) ? VOLLEY_EVENT_HAS_INDICES : 0;
+
+	//captured before firing, so the receiver scatters from the same generator state
+	event.resize(VOLLEY_EVENT_SIZE + indices.size() * 2);
+	uint8_t *w = event.ptrw();
+	w[0] = VOLLEY_EVENT_VERSION;
+	w[1] = flags;
+	w[2] = aim_mode;
+	w[3] = scatter_mode;
+	w += 4;
+	w += encode_uint32(p_tick, w);
+	w += encode_uint64(_scatter_rng.get_state(), w);
+	Transform2D xform = get_global_transform();
+	w += encode_float(xform.get_origin().x, w);
+	w += encode_float(xform.get_origin().y, w);
+	w += encode_float(xform.get_rotation(), w);
+	w += encode_float(xform.get_scale().x, w);
+	w += encode_float(xform.get_scale().y, w);
+	w += encode_uint16(shot_count, w);
+	w += encode_uint16(indices.size(), w);
+	w += encode_float(radius, w);
+	w += encode_float(arc_width, w);
+	w += encode_float(arc_rotation, w);
+	w += encode_float(arc_offset, w);
+	w += encode_float(aim_angle, w);
+	w += encode_float(aim_target_position.x, w);
+	w += encode_float(aim_target_position.y, w);
+	w += encode_float(scatter_range, w);
+	for (int i = 0; i < indices.size(); i++) {
+		w += encode_uint16(indices[i], w);
+	}
+
+	if (flags & VOLLEY_EVENT_HAS_INDICES) {
+		fire_shots(indices);
+	} else {
+		fire();
+	}
+	return event;
+}
+
+Error BulletSpawner::apply_volley_event(const PackedByteArray &p_event, int p_current_tick) {
+	ERR_FAIL_COND_V_MSG(p_event.size() < VOLLEY_EVENT_SIZE, ERR_INVALID_DATA, "Volley event is too short.");
+	const uint8_t *r = p_event.ptr();
+	ERR_FAIL_COND_V_MSG(r[0] != VOLLEY_EVENT_VERSION, ERR_INVALID_DATA, vformat("Unsupported volley event version %d.", r[0]));
+	ERR_FAIL_COND_V_MSG(r[2] > TARGET_GLOBAL || r[3] > VOLLEY, ERR_INVALID_DATA, "Volley event is corrupt.");
+	uint16_t event_shot_count = decode_uint16(r + 36);
+	uint16_t index_count = decode_uint16(r + 38);
+	ERR_FAIL_COND_V_MSG(p_event.size() != VOLLEY_EVENT_SIZE + index_count * 2, ERR_INVALID_DATA, "Volley event is corrupt.");
+	ERR_FAIL_COND_V_MSG(event_shot_count < 1 || event_shot_count > VOLLEY_EVENT_MAX_SHOTS, ERR_INVALID_DATA, vformat("Volley event is corrupt, or has more than %d shots.", VOLLEY_EVENT_MAX_SHOTS));
+	if (!can_fire()) {
+		return ERR_UNCONFIGURED;
+	}
+
+	uint8_t flags = r[1];
+	VolleySettings settings;
+	settings.aim_mode = (AimMode)r[2];
+	settings.scatter_mode = (ScatterMode)r[3];
+	uint32_t tick = decode_uint32(r + 4);
+	settings.scatter_state = decode_uint64(r + 8);
+	Vector2 origin = Vector2(decode_float(r + 16), decode_float(r + 20));
+	float rotation = decode_float(r + 24);
+	Vector2 scale = Vector2(decode_float(r + 28), decode_float(r + 32));
+	settings.shot_count = event_shot_count;
+	settings.radius = decode_float(r + 40);
+	settings.arc_width = decode_float(r + 44);
+	settings.arc_rotation = decode_float(r + 48);
+	settings.arc_offset = decode_float(r + 52);
+	settings.aim_angle = decode_float(r + 56);
+	settings.aim_target_position = Vector2(decode_float(r + 60), decode_float(r + 64));
+	settings.scatter_range = decode_float(r + 68);
+	PackedInt32Array indices;
+	indices.resize(index_count);
+	for (int i = 0; i < index_count; i++) {
+		indices.write[i] = decode_uint16(r + VOLLEY_EVENT_SIZE + i * 2);
+	}
+
+	uint64_t trace_start = BulletTracer::get_singleton()->begin_span();
+	//the spawner's own settings and placement are put back once the sender's volley is built
+	_swap_volley_settings(settings);
+	_event_transform = Transform2D(rotation, scale, 0.0, origin);
+	_event_transform_active = true;
+	_volley_changed = true;
+	Array volley = (flags & VOLLEY_EVENT_HAS_INDICES) ? _get_selected_shots(get_scattered_volley(), indices) : get_scattered_volley();
+	_event_transform_active = false;
+	_swap_volley_settings(settings);
+	_volley_changed = true;
+
+	//late events are caught up by spawning their bullets as old as they are on the sender
+	float age = (p_current_tick - (int64_t)tick) / (float)_get_event_ticks_per_second();
+	if (age > 0.0) {
+		Array aged_volley;
+		for (int i = 0; i < volley.size(); i++) {
+			Dictionary shot = volley[i];
+			shot = shot.duplicate();
+			shot["age"] = age;
+			aged_volley.push_back(shot);
+		}
+		volley = aged_volley;
+	}
+	emit_signal("volley_fired", origin, volley, bullet_texture, custom_bullet_data);
+	BulletTracer::get_singleton()->end_span("apply_volley_event", this, trace_start, volley.size());
+	return OK;
+}
+
+//event ticks are counted at the rate of the server the volleys end up on, found through the relay if needed
+int BulletSpawner::_get_event_ticks_per_second() const {
+	List<Connection> connections;
+	get_signal_connection_list("volley_fired", &connections);
+	for (const Connection &E : connections) {
+		Object *target = E.callable.get_object();
+		List<Connection> relayed;
+		if (Object::cast_to<BulletServerRelay>(target)) {
+			target->get_signal_connection_list("volley_spawn_requested", &relayed);
+		} else {
+			relayed.push_back(E);
+		}
+		for (const Connection &R : relayed) {
+			BulletServer *server = Object::cast_to<BulletServer>(R.callable.get_object());
+			if (server && server->get_sim_ticks_per_second() > 0) {
+				return server->get_sim_ticks_per_second();
+			} else if (server) {
+				return Engine::get_singleton()->get_physics_ticks_per_second();
+			}
+		}
+	}
+	return Engine::get_singleton()->get_physics_ticks_per_second();
+}
+
+void BulletSpawner::_swap_volley_settings(VolleySettings &r_settings) {
+	SWAP(aim_mode, r_settings.aim_mode);
+	SWAP(scatter_mode, r_settings.scatter_mode);
+	SWAP(shot_count, r_settings.shot_count);
+	SWAP(radius, r_settings.radius);
+	SWAP(arc_width, r_settings.arc_width);
+	SWAP(arc_rotation, r_settings.arc_rotation);
+	SWAP(arc_offset, r_settings.arc_offset);
+	SWAP(aim_angle, r_settings.aim_angle);
+	SWAP(aim_target_position, r_settings.aim_target_position);
+	SWAP(scatter_range, r_settings.scatter_range);
+	uint64_t scatter_state = _scatter_rng.get_state();
+	_scatter_rng.set_state(r_settings.scatter_state);
+	r_settings.scatter_state = scatter_state;
+}
+
+Transform2D BulletSpawner::_get_volley_transform() const {
+	return _event_transform_active ? _event_transform : get_global_transform();
 }
 
 Array BulletSpawner::get_volley() {
@@ -104,8 +291,13 @@ Array BulletSpawner::get_scattered_volley() {
 
 	switch (scatter_mode) {
 		case BULLET:
+			//offsets are drawn up front in shot order, so the sequence only depends on the seed and shot count
+			_scatter_offsets.resize(s_volley.size());
+			for (uint32_t i = 0; i < _scatter_offsets.size(); i++) {
+				_scatter_offsets[i] = _scatter_rng.randf() * scatter_range - scatter_range / 2;
+			}
 			for (int i = 0; i < s_volley.size(); i++) {
-				rand_offset = Math::randf() * scatter_range - scatter_range / 2;
+				rand_offset = _scatter_offsets[i];
 				Dictionary shot_info = s_volley[i];
 				Vector2 dir = Vector2(shot_info["direction"]).rotated(rand_offset);
 				shot_info["direction"] = dir;
@@ -114,7 +306,7 @@ Array BulletSpawner::get_scattered_volley() {
 			break;
 
 		case VOLLEY:
-			rand_offset = Math::randf() * scatter_range - scatter_range / 2;
+			rand_offset = _scatter_rng.randf() * scatter_range - scatter_range / 2;
 			for (int i = 0; i < s_volley.size(); i++) {
 				Dictionary shot_info = s_volley[i];
 				Vector2 dir = Vector2(shot_info["direction"]).rotated(rand_offset);
@@ -202,23 +394,25 @@ Array BulletSpawner::_create_volley() const {
 }
 
 Vector2 BulletSpawner::_get_shot_position(const Vector2 &p_normal) const {
-	return (p_normal * radius * get_global_scale()).rotated(get_global_rotation());
+	Transform2D xform = _get_volley_transform();
+	return (p_normal * radius * xform.get_scale()).rotated(xform.get_rotation());
 }
 
 Vector2 BulletSpawner::_get_shot_direction(const Vector2 &p_position, const Vector2 &p_normal) const {
+	Transform2D xform = _get_volley_transform();
 	Vector2 direction;
 	switch (aim_mode) {
 		case RADIAL: {
-			direction = p_normal.rotated(aim_angle + get_global_rotation());
+			direction = p_normal.rotated(aim_angle + xform.get_rotation());
 		} break;
 		case UNIFORM: {
-			direction = Vector2(1, 0).rotated(aim_angle + get_global_rotation());
+			direction = Vector2(1, 0).rotated(aim_angle + xform.get_rotation());
 		} break;
 		case TARGET_RELATIVE: {
 			direction = (aim_target_position - p_position).normalized();
 		} break;
 		case TARGET_GLOBAL: {
-			direction = (aim_target_position - (get_global_position() + p_position)).normalized();
+			direction = (aim_target_position - (xform.get_origin() + p_position)).normalized();
 		} break;
 		default: {
 		} break;
@@ -250,8 +444,10 @@ void BulletSpawner::set_autofire(bool p_enabled) {
 	autofire = p_enabled;
 	if (autofire) {
 		_autofire_time = INFINITY;
+		_autofire_frames = interval_frames;
 	} else {
 		_autofire_time = 0;
+		_autofire_frames = 0;
 	}
 }
 
@@ -267,6 +463,17 @@ int BulletSpawner::get_interval_frames() const {
 	return interval_frames;
 }
 
+void BulletSpawner::set_deterministic(bool p_enabled) {
+	deterministic = p_enabled;
+	if (deterministic) {
+		_scatter_rng.seed(scatter_seed);
+	}
+}
+
+bool BulletSpawner::get_deterministic() const {
+	return deterministic;
+}
+
 void BulletSpawner::set_bullet_path(const Ref<BulletPath> &p_path) {
 	bullet_path = p_path;
 	_notify_volley_changed();
@@ -421,6 +628,23 @@ float BulletSpawner::get_scatter_range_degrees() const {
 	return Math::rad_to_deg(scatter_range);
 }
 
+void BulletSpawner::set_scatter_seed(int64_t p_seed) {
+	scatter_seed = p_seed;
+	_scatter_rng.seed(scatter_seed);
+}
+
+int64_t BulletSpawner::get_scatter_seed() const {
+	return scatter_seed;
+}
+
+void BulletSpawner::set_scatter_rng_state(int64_t p_state) {
+	_scatter_rng.set_state(p_state);
+}
+
+int64_t BulletSpawner::get_scatter_rng_state() const {
+	return _scatter_rng.get_state();
+}
+
 void BulletSpawner::set_pattern_mode(PatternMode p_mode) {
 	pattern_mode = p_mode;
 	_notify_volley_changed();
@@ -650,6 +874,9 @@ void BulletSpawner::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("fire"), &BulletSpawner::fire);
 	ClassDB::bind_method(D_METHOD("fire_shots", "shot_indices"), &BulletSpawner::fire_shots);
 
+	ClassDB::bind_method(D_METHOD("fire_event", "tick", "shot_indices"), &BulletSpawner::fire_event, DEFVAL(PackedInt32Array()));
+	ClassDB::bind_method(D_METHOD("apply_volley_event", "event", "current_tick"), &BulletSpawner::apply_volley_event);
+
 	ClassDB::bind_method(D_METHOD("get_volley"), &BulletSpawner::get_volley);
 	ClassDB::bind_method(D_METHOD("get_scattered_volley"), &BulletSpawner::get_scattered_volley);
 
@@ -659,6 +886,9 @@ void BulletSpawner::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_interval_frames", "interval"), &BulletSpawner::set_interval_frames);
 	ClassDB::bind_method(D_METHOD("get_interval_frames"), &BulletSpawner::get_interval_frames);
 
+	ClassDB::bind_method(D_METHOD("set_deterministic", "enabled"), &BulletSpawner::set_deterministic);
+	ClassDB::bind_method(D_METHOD("get_deterministic"), &BulletSpawner::get_deterministic);
+
 	ClassDB::bind_method(D_METHOD("set_shot_count", "count"), &BulletSpawner::set_shot_count);
 	ClassDB::bind_method(D_METHOD("get_shot_count"), &BulletSpawner::get_shot_count);
 
@@ -710,6 +940,12 @@ void BulletSpawner::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_scatter_range_degrees", "degrees"), &BulletSpawner::set_scatter_range_degrees);
 	ClassDB::bind_method(D_METHOD("get_scatter_range_degrees"), &BulletSpawner::get_scatter_range_degrees);
 
+	ClassDB::bind_method(D_METHOD("set_scatter_seed", "seed"), &BulletSpawner::set_scatter_seed);
+	ClassDB::bind_method(D_METHOD("get_scatter_seed"), &BulletSpawner::get_scatter_seed);
+
+	ClassDB::bind_method(D_METHOD("set_scatter_rng_state", "state"), &BulletSpawner::set_scatter_rng_state);
+	ClassDB::bind_method(D_METHOD("get_scatter_rng_state"), &BulletSpawner::get_scatter_rng_state);
+
 	ClassDB::bind_method(D_METHOD("set_pattern_mode", "mode"), &BulletSpawner::set_pattern_mode);
 	ClassDB::bind_method(D_METHOD("get_pattern_mode"), &BulletSpawner::get_pattern_mode);
 
@@ -736,6 +972,7 @@ void BulletSpawner::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "autofire"), "set_autofire", "get_autofire");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "interval_frames", PROPERTY_HINT_RANGE, "1,300,or_greater"), "set_interval_frames", "get_interval_frames");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deterministic"), "set_deterministic", "get_deterministic");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "shot_count", PROPERTY_HINT_RANGE, "1,100,or_greater"), "set_shot_count", "get_shot_count");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "radius", PROPERTY_HINT_RANGE, "0,500,0.01,or_greater"), "set_radius", "get_radius");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "arc_width", PROPERTY_HINT_RANGE, "", PROPERTY_USAGE_NO_EDITOR), "set_arc_width", "get_arc_width");
@@ -756,6 +993,7 @@ void BulletSpawner::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "scatter_mode", PROPERTY_HINT_ENUM, "None,Bullet,Volley"), "set_scatter_mode", "get_scatter_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "scatter_range", PROPERTY_HINT_RANGE, "", PROPERTY_USAGE_NO_EDITOR), "set_scatter_range", "get_scatter_range");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "scatter_range_degrees", PROPERTY_HINT_RANGE, "0,360,0.1,or_less,or_greater", PROPERTY_USAGE_EDITOR), "set_scatter_range_degrees", "get_scatter_range_degrees");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "scatter_seed"), "set_scatter_seed", "get_scatter_seed");
 	ADD_GROUP("Pattern", "");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "pattern_mode", PROPERTY_HINT_ENUM, "All,Manual"), "set_pattern_mode", "get_pattern_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "active_shot_indices"), "set_active_shot_indices", "get_active_shot_indices");
@@ -769,7 +1007,6 @@ void BulletSpawner::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "relay_autoconnect"), "set_relay_autoconnect", "get_relay_autoconnect");
 
 	ADD_SIGNAL(MethodInfo("volley_fired",
-			PropertyInfo(Variant::OBJECT, "path", PROPERTY_HINT_RESOURCE_TYPE, "BulletPath"),
 			PropertyInfo(Variant::VECTOR2, "origin"),
 			PropertyInfo(Variant::ARRAY, "volley"),
 			PropertyInfo(Variant::OBJECT, "texture", PROPERTY_HINT_RESOURCE_TYPE, "BulletTexture"),
@@ -793,8 +1030,11 @@ void BulletSpawner::_bind_methods() {
 BulletSpawner::BulletSpawner() {
 	autofire = false;
 	_autofire_time = 0.0;
+	_autofire_frames = 0;
 	interval_frames = 10;
 
+	deterministic = false;
+
 	shot_count = 1;
 
 	radius = 10.0;
@@ -812,6 +1052,7 @@ BulletSpawner::BulletSpawner() {
 
 	scatter_mode = NONE;
 	scatter_range = 0.0;
+	scatter_seed = 0;
 
 	pattern_mode = ALL;
 	active_shot_indices = PackedInt32Array();
@@ -828,6 +1069,7 @@ BulletSpawner::BulletSpawner() {
 	_volley_changed = true;
 
 	_previous_transform = Transform2D();
+	_event_transform_active = false;
 }
 
 BulletSpawner::~BulletSpawner() {
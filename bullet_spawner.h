@@ -7,6 +7,8 @@
 
 #include "core/config/engine.h"
 #include "core/config/project_settings.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/local_vector.h"
 #include "scene/2d/node_2d.h"
 
 class BulletSpawner : public Node2D {
@@ -34,8 +36,11 @@ public:
 private:
 	bool autofire;
 	float _autofire_time;
+	int _autofire_frames;
 	int interval_frames;
 
+	bool deterministic;
+
 	int shot_count;
 
 	float radius;
@@ -53,6 +58,9 @@ private:
 
 	ScatterMode scatter_mode;
 	float scatter_range;
+	int64_t scatter_seed;
+	RandomPCG _scatter_rng;
+	LocalVector<float> _scatter_offsets;
 
 	PatternMode pattern_mode;
 	PackedInt32Array active_shot_indices;
@@ -70,6 +78,27 @@ private:
 
 	Transform2D _previous_transform;
 
+	//volley events are built from the sender's settings and transform, swapped in only while the volley is built
+	struct VolleySettings {
+		AimMode aim_mode = RADIAL;
+		ScatterMode scatter_mode = NONE;
+		int shot_count = 1;
+		float radius = 0.0;
+		float arc_width = 0.0;
+		float arc_rotation = 0.0;
+		float arc_offset = 0.0;
+		float aim_angle = 0.0;
+		Vector2 aim_target_position;
+		float scatter_range = 0.0;
+		uint64_t scatter_state = 0;
+	};
+	bool _event_transform_active;
+	Transform2D _event_transform;
+
+	void _swap_volley_settings(VolleySettings &r_settings);
+	Transform2D _get_volley_transform() const;
+	int _get_event_ticks_per_second() const;
+
 	Array _get_selected_shots(const Array &p_volley, const PackedInt32Array &p_shot_indices) const;
 
 	void _notify_volley_changed();
@@ -95,6 +124,9 @@ public:
 	void fire();
 	void fire_shots(const PackedInt32Array &p_shot_indices);
 
+	PackedByteArray fire_event(int p_tick, const PackedInt32Array &p_shot_indices = PackedInt32Array());
+	Error apply_volley_event(const PackedByteArray &p_event, int p_current_tick);
+
 	Array get_volley();
 	Array get_scattered_volley();
 
@@ -104,6 +136,9 @@ public:
 	void set_interval_frames(int p_interval);
 	int get_interval_frames() const;
 
+	void set_deterministic(bool p_enabled);
+	bool get_deterministic() const;
+
 	void set_shot_count(int p_count);
 	int get_shot_count() const;
 
@@ -155,6 +190,12 @@ public:
 	void set_scatter_range_degrees(float p_degrees);
 	float get_scatter_range_degrees() const;
 
+	void set_scatter_seed(int64_t p_seed);
+	int64_t get_scatter_seed() const;
+
+	void set_scatter_rng_state(int64_t p_state);
+	int64_t get_scatter_rng_state() const;
+
 	void set_pattern_mode(PatternMode p_mode);
 	PatternMode get_pattern_mode() const;
 
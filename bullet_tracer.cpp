@@ -0,0 +1,134 @@
+#include "bullet_tracer.h"
+
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+#include "core/string/string_builder.h"
+#include "core/templates/hash_map.h"
+#include "scene/main/node.h"
+
+BulletTracer *BulletTracer::singleton = nullptr;
+
+BulletTracer *BulletTracer::get_singleton() {
+	return singleton;
+}
+
+uint64_t BulletTracer::begin_span() const {
+	if (!active) {
+		return 0;
+	}
+	return OS::get_singleton()->get_ticks_usec();
+}
+
+uint64_t BulletTracer::end_span(const char *p_name, const Object *p_source, uint64_t p_start, int p_count) {
+	if (!active || p_start == 0) {
+		return 0;
+	}
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+
+	Span &span = spans[next_span];
+	span.name = p_name;
+	span.source = p_source->get_instance_id();
+	span.start = p_start;
+	span.end = now;
+	span.count = p_count;
+
+	next_span++;
+	if (next_span == spans.size()) {
+		next_span = 0;
+		wrapped = true;
+	}
+
+	//returned so consecutive phases can chain without reading the clock twice
+	return now;
+}
+
+void BulletTracer::start(float p_window, int p_capacity) {
+	ERR_FAIL_COND_MSG(p_capacity < 1, "Trace capacity must be at least one span.");
+	window = p_window;
+	spans.resize(p_capacity);
+	clear();
+	active = true;
+}
+
+void BulletTracer::stop() {
+	active = false;
+}
+
+void BulletTracer::clear() {
+	next_span = 0;
+	wrapped = false;
+}
+
+Error BulletTracer::dump(const String &p_path) const {
+	Error err;
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot open trace file '" + p_path + "' for writing.");
+
+	uint64_t cutoff = 0;
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+	uint64_t window_usec = window * 1000000;
+	if (window_usec > 0 && now > window_usec) {
+		cutoff = now - window_usec;
+	}
+
+	//each traced node gets its own row, named after the node if it still exists
+	HashMap<ObjectID, int> rows;
+
+	StringBuilder json;
+	json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+
+	uint32_t count = wrapped ? spans.size() : next_span;
+	uint32_t oldest = wrapped ? next_span : 0;
+	for (uint32_t i = 0; i < count; i++) {
+		const Span &span = spans[(oldest + i) % spans.size()];
+		if (span.end < cutoff) {
+			continue;
+		}
+
+		if (!rows.has(span.source)) {
+			int row = rows.size() + 1;
+			rows[span.source] = row;
+
+			String row_name = "Object " + itos(span.source);
+			Node *node = Object::cast_to<Node>(ObjectDB::get_instance(span.source));
+			if (node) {
+				row_name = String(node->get_name()) + " (" + node->get_class() + ")";
+			}
+			json += first ? "" : ",";
+			json += vformat("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", row, row_name.json_escape());
+			first = false;
+		}
+
+		json += first ? "" : ",";
+		json += vformat("{\"name\":\"%s\",\"cat\":\"qurobullet\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%d,\"dur\":%d,\"args\":{\"bullets\":%d}}",
+				span.name, rows[span.source], (int64_t)span.start, (int64_t)(span.end - span.start), span.count);
+		first = false;
+	}
+	json += "]}";
+
+	file->store_string(json.as_string());
+	return OK;
+}
+
+void BulletTracer::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("start", "window", "capacity"), &BulletTracer::start, DEFVAL(5.0), DEFVAL(65536));
+	ClassDB::bind_method(D_METHOD("stop"), &BulletTracer::stop);
+	ClassDB::bind_method(D_METHOD("clear"), &BulletTracer::clear);
+	ClassDB::bind_method(D_METHOD("is_active"), &BulletTracer::is_active);
+	ClassDB::bind_method(D_METHOD("dump", "path"), &BulletTracer::dump);
+}
+
+BulletTracer::BulletTracer() {
+	singleton = this;
+	active = false;
+	window = 5.0;
+	next_span = 0;
+	wrapped = false;
+}
+
+BulletTracer::~BulletTracer() {
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+}
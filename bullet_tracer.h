@@ -0,0 +1,47 @@
+#ifndef BULLETTRACER_H
+#define BULLETTRACER_H
+
+#include "core/object/object.h"
+#include "core/templates/local_vector.h"
+
+class BulletTracer : public Object {
+	GDCLASS(BulletTracer, Object);
+
+	struct Span {
+		const char *name;
+		ObjectID source;
+		uint64_t start;
+		uint64_t end;
+		int count;
+	};
+
+	static BulletTracer *singleton;
+
+	bool active;
+	float window;
+	LocalVector<Span> spans;
+	uint32_t next_span;
+	bool wrapped;
+
+protected:
+	static void _bind_methods();
+
+public:
+	static BulletTracer *get_singleton();
+
+	_FORCE_INLINE_ bool is_active() const { return active; }
+
+	uint64_t begin_span() const;
+	uint64_t end_span(const char *p_name, const Object *p_source, uint64_t p_start, int p_count);
+
+	void start(float p_window = 5.0, int p_capacity = 65536);
+	void stop();
+	void clear();
+
+	Error dump(const String &p_path) const;
+
+	BulletTracer();
+	~BulletTracer();
+};
+
+#endif
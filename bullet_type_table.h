@@ -0,0 +1,126 @@
+#ifndef BULLETTYPETABLE_H
+#define BULLETTYPETABLE_H
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Maps shared bullet data (paths, textures, custom data) to compact ids that
+// stay stable while the data is in use. Entries that go unused for longer than
+// the caller's retention period can be pruned and their ids reused, or entries
+// can be reference counted and freed as soon as nothing holds them. Each reuse
+// of an id bumps its generation, so an (id, generation) pair saved earlier can
+// tell whether the id still means the same value.
+template <typename T>
+class BulletTypeTable {
+	struct Entry {
+		T value;
+		const void *key = nullptr;
+		uint64_t last_used = 0;
+		uint32_t refs = 0;
+		uint32_t generation = 0;
+	};
+
+	// id 0 is reserved for "no value"
+	LocalVector<Entry> entries;
+	HashMap<const void *, uint32_t> ids;
+	LocalVector<uint32_t> free_ids;
+
+	void _erase(uint32_t p_id) {
+		Entry &entry = entries[p_id];
+		ids.erase(entry.key);
+		entry.value = T();
+		entry.key = nullptr;
+		entry.refs = 0;
+		entry.generation++;
+		free_ids.push_back(p_id);
+	}
+
+public:
+	_FORCE_INLINE_ bool has(uint32_t p_id) const {
+		return p_id > 0 && p_id < entries.size() && entries[p_id].key != nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(uint32_t p_id, uint32_t p_generation) const {
+		return has(p_id) && entries[p_id].generation == p_generation;
+	}
+
+	_FORCE_INLINE_ uint32_t get_generation(uint32_t p_id) const {
+		return p_id > 0 && p_id < entries.size() ? entries[p_id].generation : 0;
+	}
+
+	_FORCE_INLINE_ const T &get(uint32_t p_id) const {
+		return entries[p_id].value;
+	}
+
+	// p_hint is the id this value had last time, which skips the hash lookup when still valid
+	uint32_t intern(const T &p_value, const void *p_key, uint64_t p_tick, uint32_t p_hint = 0) {
+		if (p_key == nullptr) {
+			return 0;
+		}
+		if (p_hint > 0 && p_hint < entries.size() && entries[p_hint].key == p_key) {
+			entries[p_hint].last_used = p_tick;
+			return p_hint;
+		}
+
+		const uint32_t *existing = ids.getptr(p_key);
+		if (existing) {
+			entries[*existing].last_used = p_tick;
+			return *existing;
+		}
+
+		uint32_t id;
+		if (!free_ids.is_empty()) {
+			id = free_ids[free_ids.size() - 1];
+			free_ids.resize(free_ids.size() - 1);
+		} else {
+			if (entries.is_empty()) {
+				entries.resize(1);
+			}
+			id = entries.size();
+			entries.resize(id + 1);
+		}
+
+		Entry &entry = entries[id];
+		entry.value = p_value;
+		entry.key = p_key;
+		entry.last_used = p_tick;
+		ids.insert(p_key, id);
+		return id;
+	}
+
+	// interns and holds the value until a matching release()
+	uint32_t acquire(const T &p_value, const void *p_key, uint32_t p_hint = 0) {
+		uint32_t id = intern(p_value, p_key, 0, p_hint);
+		if (id > 0) {
+			entries[id].refs++;
+		}
+		return id;
+	}
+
+	void release(uint32_t p_id) {
+		if (p_id > 0 && --entries[p_id].refs == 0) {
+			_erase(p_id);
+		}
+	}
+
+	void prune(uint64_t p_unused_since) {
+		for (uint32_t i = 1; i < entries.size(); i++) {
+			Entry &entry = entries[i];
+			if (entry.key != nullptr && entry.refs == 0 && entry.last_used < p_unused_since) {
+				_erase(i);
+			}
+		}
+	}
+
+	void clear() {
+		entries.clear();
+		ids.clear();
+		free_ids.clear();
+	}
+
+	uint32_t size() const {
+		return ids.size();
+	}
+};
+
+#endif
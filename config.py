@@ -6,14 +6,27 @@ def can_build(env, platform):
 def configure(env):
     pass
 
+def get_opts(platform):
+    from SCons.Variables import BoolVariable
+
+    return [
+        BoolVariable("qurobullet_monitors_in_release", "Keep BulletServer performance monitors in release export templates", True),
+    ]
+
 def get_doc_classes():
     return [
         "Bullet",
         "BulletType",
         "BulletSpawner",
         "BulletServer",
-        "BulletServerRelay"
+        "BulletServerRelay",
+        "BulletTracer",
+        "BulletPattern",
+        "BulletProgram",
+        "HomingBulletPath",
+        "CurveBulletPath",
+        "SequenceBulletPath",
     ]
 
 def get_doc_path():
-    return "doc_classes"
\ No newline at end of file
+    return "doc_classes"
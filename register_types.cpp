@@ -6,37 +6,55 @@
 #include "bullet_server.h"
 #include "bullet_server_relay.h"
 #include "bullet_spawner.h"
+#include "bullet_tracer.h"
 
 #include "resource/bullet_path.h"
+#include "resource/bullet_pattern.h"
+#include "resource/bullet_program.h"
 #include "resource/simple_bullet_path.h"
 #include "resource/bezier_bullet_path.h"
+#include "resource/curve_bullet_path.h"
 #include "resource/force_bullet_path.h"
+#include "resource/homing_bullet_path.h"
+#include "resource/sequence_bullet_path.h"
 #include "resource/bullet_texture.h"
 
 #include "core/config/engine.h"
 #include "core/object/class_db.h"
 
 BulletServerRelay *_bullet_server_relay = nullptr;
+BulletTracer *_bullet_tracer = nullptr;
 
 void initialize_qurobullet_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
 	_bullet_server_relay = memnew(BulletServerRelay);
+	_bullet_tracer = memnew(BulletTracer);
 
 	GDREGISTER_CLASS(Bullet);
 	GDREGISTER_CLASS(BulletServer);
 	GDREGISTER_CLASS(BulletServerRelay);
 	GDREGISTER_CLASS(BulletSpawner);
+	GDREGISTER_CLASS(BulletTracer);
 
 	GDREGISTER_ABSTRACT_CLASS(BulletPath);
 	GDREGISTER_CLASS(SimpleBulletPath);
 	GDREGISTER_CLASS(BezierBulletPath);
+	GDREGISTER_CLASS(CurveBulletPath);
 	GDREGISTER_CLASS(ForceBulletPath);
+	GDREGISTER_CLASS(HomingBulletPath);
+	GDREGISTER_CLASS(SequenceBulletPath);
 	
 	GDREGISTER_CLASS(BulletTexture);
+	GDREGISTER_CLASS(BulletPattern);
+	GDREGISTER_CLASS(BulletProgram);
 
 	Engine *engine = Engine::get_singleton();
+	if (!engine->has_singleton("BulletTracer")) {
+		engine->add_singleton(Engine::Singleton("BulletTracer", _bullet_tracer));
+	}
+
 	if (engine->has_singleton("BulletServerRelay")) {
 		return;
 	}
@@ -54,7 +72,15 @@ void uninitialize_qurobullet_module(ModuleInitializationLevel p_level) {
 		engine->remove_singleton("BulletServerRelay");
 	}
 
+	if (engine->has_singleton("BulletTracer")) {
+		engine->remove_singleton("BulletTracer");
+	}
+
 	if (_bullet_server_relay) {
 		memdelete(_bullet_server_relay);
 	}
+
+	if (_bullet_tracer) {
+		memdelete(_bullet_tracer);
+	}
 }
@@ -77,7 +77,9 @@ Ref<BulletPath> BezierBulletPath::rotated(float p_rotation) const {
         );
     }
 
-    return Ref<BezierBulletPath>(memnew(BezierBulletPath(new_curve, mode, speed, continue_on_complete)));
+    Ref<BezierBulletPath> new_path = Ref<BezierBulletPath>(memnew(BezierBulletPath(new_curve, mode, speed, continue_on_complete)));
+    new_path->_set_rotation_source(this, p_rotation);
+    return new_path;
 }
 
 Ref<BulletPath> BezierBulletPath::xformed(const Transform2D &p_transform) const {
@@ -7,7 +7,23 @@
 class BulletPath : public Resource {
     GDCLASS(BulletPath, Resource);
 
+    // rotated copies remember the path they were made from, so they can be referred to by its resource id
+    Ref<BulletPath> rotation_source;
+    float source_rotation = 0.0;
+
+protected:
+    void _set_rotation_source(const BulletPath *p_path, float p_rotation) {
+        rotation_source = p_path->rotation_source.is_valid() ? p_path->rotation_source : Ref<BulletPath>(const_cast<BulletPath *>(p_path));
+        source_rotation = p_path->source_rotation + p_rotation;
+    }
+
 public:
+    Ref<BulletPath> get_rotation_source() const { return rotation_source; }
+    float get_source_rotation() const { return source_rotation; }
+
+    // homing paths are steered by the server from per-bullet state rather than stepped by time
+    virtual bool is_homing() const { return false; }
+
 	virtual float get_lifetime() const = 0;
 
     virtual Vector2 get_step(float p_time, float p_delta) const = 0;
@@ -0,0 +1,388 @@
+#include "bullet_pattern.h"
+
+#include "core/io/xml_parser.h"
+#include "core/templates/hash_map.h"
+
+// BulletML documents are read into a small tree first, since actions can be
+// referenced by label before they are defined.
+struct BulletMLNode {
+	String name;
+	String label;
+	String type;
+	String text;
+	LocalVector<int> children;
+};
+
+static int _find_bulletml_child(const LocalVector<BulletMLNode> &p_nodes, int p_node, const String &p_name) {
+	for (uint32_t i = 0; i < p_nodes[p_node].children.size(); i++) {
+		if (p_nodes[p_nodes[p_node].children[i]].name == p_name) {
+			return p_nodes[p_node].children[i];
+		}
+	}
+	return -1;
+}
+
+static bool _get_bulletml_number(const BulletMLNode &p_node, String &r_value) {
+	r_value = p_node.text.strip_edges();
+	ERR_FAIL_COND_V_MSG(!r_value.is_valid_float(), false, vformat("BulletML <%s> contains '%s'. Only numeric values are supported, not expressions.", p_node.name, r_value));
+	return true;
+}
+
+//bulletml angles are clockwise from up, pattern angles are clockwise from the runner's facing (right)
+static bool _append_bulletml_direction(const BulletMLNode &p_node, String &r_source) {
+	String value;
+	if (!_get_bulletml_number(p_node, value)) {
+		return false;
+	}
+	if (p_node.type == "absolute") {
+		r_source += vformat("direction %f\n", value.to_float() - 90.0);
+	} else if (p_node.type == "relative") {
+		r_source += vformat("direction %s\n", value);
+	} else if (p_node.type == "sequence") {
+		r_source += vformat("turn %s\n", value);
+	} else {
+		r_source += vformat("aim\nturn %s\n", value);
+	}
+	return true;
+}
+
+static bool _append_bulletml_speed(const BulletMLNode &p_node, String &r_source) {
+	String value;
+	if (!_get_bulletml_number(p_node, value)) {
+		return false;
+	}
+	if (p_node.type == "relative") {
+		r_source += vformat("accel %s\n", value);
+	} else if (p_node.type == "sequence") {
+		r_source += vformat("accel %s\n", value);
+	} else {
+		r_source += vformat("speed %s\n", value);
+	}
+	return true;
+}
+
+static bool _append_bulletml_action(const LocalVector<BulletMLNode> &p_nodes, const HashMap<String, int> &p_labels, int p_node, String &r_source, int p_depth) {
+	ERR_FAIL_COND_V_MSG(p_depth > 16, false, "BulletML actions are nested or referenced too deeply.");
+
+	for (uint32_t i = 0; i < p_nodes[p_node].children.size(); i++) {
+		int child = p_nodes[p_node].children[i];
+		const BulletMLNode &node = p_nodes[child];
+		String value;
+
+		if (node.name == "action" || node.name == "actionRef") {
+			int action = child;
+			if (node.name == "actionRef") {
+				ERR_FAIL_COND_V_MSG(!p_labels.has(node.label), false, vformat("BulletML references unknown action '%s'.", node.label));
+				action = p_labels[node.label];
+			}
+			if (!_append_bulletml_action(p_nodes, p_labels, action, r_source, p_depth + 1)) {
+				return false;
+			}
+
+		} else if (node.name == "fire" || node.name == "fireRef") {
+			int fire = child;
+			if (node.name == "fireRef") {
+				ERR_FAIL_COND_V_MSG(!p_labels.has(node.label), false, vformat("BulletML references unknown fire '%s'.", node.label));
+				fire = p_labels[node.label];
+			}
+			//direction and speed may be given on the fire or on its bullet, and bulletml aims by default
+			int bullet = _find_bulletml_child(p_nodes, fire, "bullet");
+			int direction = _find_bulletml_child(p_nodes, fire, "direction");
+			int speed = _find_bulletml_child(p_nodes, fire, "speed");
+			if (bullet != -1 && direction == -1) {
+				direction = _find_bulletml_child(p_nodes, bullet, "direction");
+			}
+			if (bullet != -1 && speed == -1) {
+				speed = _find_bulletml_child(p_nodes, bullet, "speed");
+			}
+			if (direction != -1) {
+				if (!_append_bulletml_direction(p_nodes[direction], r_source)) {
+					return false;
+				}
+			} else {
+				r_source += "aim\n";
+			}
+			if (speed != -1 && !_append_bulletml_speed(p_nodes[speed], r_source)) {
+				return false;
+			}
+			r_source += "fire\n";
+			//a relative speed only applies to this shot, later ones are relative to the same speed again
+			if (speed != -1 && p_nodes[speed].type == "relative") {
+				r_source += vformat("accel %f\n", -p_nodes[speed].text.strip_edges().to_float());
+			}
+
+		} else if (node.name == "wait") {
+			if (!_get_bulletml_number(node, value)) {
+				return false;
+			}
+			r_source += vformat("wait %d\n", (int)value.to_float());
+
+		} else if (node.name == "repeat") {
+			int times = _find_bulletml_child(p_nodes, child, "times");
+			ERR_FAIL_COND_V_MSG(times == -1, false, "BulletML <repeat> has no <times>.");
+			if (!_get_bulletml_number(p_nodes[times], value)) {
+				return false;
+			}
+			r_source += vformat("repeat %d\n", MAX(1, (int)value.to_float()));
+			if (!_append_bulletml_action(p_nodes, p_labels, child, r_source, p_depth + 1)) {
+				return false;
+			}
+			r_source += "end\n";
+
+		} else if (node.name == "changeDirection") {
+			//changes are applied at once rather than over <term> frames
+			int direction = _find_bulletml_child(p_nodes, child, "direction");
+			if (direction != -1 && !_append_bulletml_direction(p_nodes[direction], r_source)) {
+				return false;
+			}
+
+		} else if (node.name == "changeSpeed") {
+			int speed = _find_bulletml_child(p_nodes, child, "speed");
+			if (speed != -1 && !_append_bulletml_speed(p_nodes[speed], r_source)) {
+				return false;
+			}
+
+		} else if (node.name != "times") {
+			WARN_PRINT(vformat("BulletML <%s> is not supported and was skipped.", node.name));
+		}
+	}
+	return true;
+}
+
+void BulletPattern::_compile() {
+	code.clear();
+	valid = true;
+
+	Vector<String> lines = source.split("\n");
+	int depth = 0;
+	for (int l = 0; l < lines.size() && valid; l++) {
+		String line = lines[l].get_slicec('#', 0).strip_edges();
+		if (line.is_empty()) {
+			continue;
+		}
+		Vector<String> args = line.split_spaces();
+		String name = args[0].to_lower();
+		Instruction instruction;
+		instruction.i = 0;
+
+		int arg_count = 1;
+		bool int_arg = false;
+		bool degrees = false;
+		if (name == "fire") {
+			instruction.op = OP_FIRE;
+			arg_count = 0;
+		} else if (name == "wait") {
+			instruction.op = OP_WAIT;
+			int_arg = true;
+		} else if (name == "repeat") {
+			instruction.op = OP_REPEAT;
+			int_arg = true;
+			depth++;
+		} else if (name == "end") {
+			instruction.op = OP_END;
+			arg_count = 0;
+			depth--;
+		} else if (name == "direction") {
+			instruction.op = OP_DIRECTION;
+			degrees = true;
+		} else if (name == "turn") {
+			instruction.op = OP_TURN;
+			degrees = true;
+		} else if (name == "aim") {
+			instruction.op = OP_AIM;
+			arg_count = 0;
+		} else if (name == "speed") {
+			instruction.op = OP_SPEED;
+		} else if (name == "accel") {
+			instruction.op = OP_ACCEL;
+		} else if (name == "shots") {
+			instruction.op = OP_SHOTS;
+			int_arg = true;
+		} else if (name == "arc") {
+			instruction.op = OP_ARC;
+			degrees = true;
+		} else if (name == "radius") {
+			instruction.op = OP_RADIUS;
+		} else if (name == "sub") {
+			instruction.op = OP_SUB;
+			int_arg = true;
+		} else {
+			ERR_PRINT(vformat("BulletPattern line %d: unknown instruction '%s'.", l + 1, args[0]));
+			valid = false;
+			break;
+		}
+
+		if (args.size() != arg_count + 1) {
+			ERR_PRINT(vformat("BulletPattern line %d: '%s' takes %d argument(s).", l + 1, name, arg_count));
+			valid = false;
+		} else if (arg_count == 1 && int_arg) {
+			if (!args[1].is_valid_int() || args[1].to_int() < 0) {
+				ERR_PRINT(vformat("BulletPattern line %d: '%s' expects a non-negative integer.", l + 1, name));
+				valid = false;
+			}
+			instruction.i = args[1].to_int();
+		} else if (arg_count == 1) {
+			if (!args[1].is_valid_float()) {
+				ERR_PRINT(vformat("BulletPattern line %d: '%s' expects a number.", l + 1, name));
+				valid = false;
+			}
+			instruction.f = degrees ? Math::deg_to_rad(args[1].to_float()) : args[1].to_float();
+		}
+		if (depth < 0) {
+			ERR_PRINT(vformat("BulletPattern line %d: 'end' without 'repeat'.", l + 1));
+			valid = false;
+		}
+		code.push_back(instruction);
+	}
+
+	if (valid && depth != 0) {
+		ERR_PRINT("BulletPattern: 'repeat' without 'end'.");
+		valid = false;
+	}
+	if (!valid) {
+		code.clear();
+	}
+}
+
+bool BulletPattern::is_valid() const {
+	return valid;
+}
+
+Error BulletPattern::import_bulletml(const String &p_xml) {
+	Ref<XMLParser> parser;
+	parser.instantiate();
+	CharString utf8 = p_xml.utf8();
+	Vector<uint8_t> buffer;
+	buffer.resize(utf8.length());
+	memcpy(buffer.ptrw(), utf8.get_data(), utf8.length());
+	Error err = parser->open_buffer(buffer);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	LocalVector<BulletMLNode> nodes;
+	LocalVector<int> stack;
+	HashMap<String, int> labels;
+	int top = -1;
+	nodes.push_back(BulletMLNode());
+	stack.push_back(0);
+
+	while (parser->read() == OK) {
+		switch (parser->get_node_type()) {
+			case XMLParser::NODE_ELEMENT: {
+				BulletMLNode node;
+				node.name = parser->get_node_name();
+				node.label = parser->get_named_attribute_value_safe("label");
+				node.type = parser->get_named_attribute_value_safe("type");
+				int index = nodes.size();
+				nodes.push_back(node);
+				nodes[stack[stack.size() - 1]].children.push_back(index);
+				if (!node.label.is_empty()) {
+					labels[node.label] = index;
+					if (node.name == "action" && node.label.begins_with("top")) {
+						if (top == -1) {
+							top = index;
+						} else {
+							WARN_PRINT(vformat("BulletML has more than one top action. Only '%s' is imported.", nodes[top].label));
+						}
+					}
+				}
+				if (!parser->is_empty()) {
+					stack.push_back(index);
+				}
+			} break;
+			case XMLParser::NODE_ELEMENT_END: {
+				ERR_FAIL_COND_V_MSG(stack.size() <= 1, ERR_PARSE_ERROR, "BulletML document is malformed.");
+				stack.resize(stack.size() - 1);
+			} break;
+			case XMLParser::NODE_TEXT: {
+				nodes[stack[stack.size() - 1]].text += parser->get_node_data();
+			} break;
+			default:
+				break;
+		}
+	}
+	ERR_FAIL_COND_V_MSG(top == -1, ERR_PARSE_ERROR, "BulletML document has no action labelled 'top'.");
+
+	String compiled;
+	ERR_FAIL_COND_V(!_append_bulletml_action(nodes, labels, top, compiled, 0), ERR_PARSE_ERROR);
+	set_source(compiled);
+	return valid ? OK : ERR_PARSE_ERROR;
+}
+
+void BulletPattern::set_source(const String &p_source) {
+	source = p_source;
+	_compile();
+	emit_changed();
+}
+
+String BulletPattern::get_source() const {
+	return source;
+}
+
+void BulletPattern::set_bullet_path(const Ref<BulletPath> &p_path) {
+	bullet_path = p_path;
+}
+
+Ref<BulletPath> BulletPattern::get_bullet_path() const {
+	return bullet_path;
+}
+
+void BulletPattern::set_bullet_texture(const Ref<BulletTexture> &p_texture) {
+	bullet_texture = p_texture;
+}
+
+Ref<BulletTexture> BulletPattern::get_bullet_texture() const {
+	return bullet_texture;
+}
+
+void BulletPattern::set_custom_data(const Dictionary &p_data) {
+	custom_data = p_data;
+}
+
+Dictionary BulletPattern::get_custom_data() const {
+	return custom_data;
+}
+
+void BulletPattern::set_sub_patterns(const Array &p_patterns) {
+	sub_patterns = p_patterns;
+}
+
+Array BulletPattern::get_sub_patterns() const {
+	return sub_patterns;
+}
+
+void BulletPattern::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("is_valid"), &BulletPattern::is_valid);
+	ClassDB::bind_method(D_METHOD("import_bulletml", "xml"), &BulletPattern::import_bulletml);
+
+	ClassDB::bind_method(D_METHOD("set_source", "source"), &BulletPattern::set_source);
+	ClassDB::bind_method(D_METHOD("get_source"), &BulletPattern::get_source);
+
+	ClassDB::bind_method(D_METHOD("set_bullet_path", "path"), &BulletPattern::set_bullet_path);
+	ClassDB::bind_method(D_METHOD("get_bullet_path"), &BulletPattern::get_bullet_path);
+
+	ClassDB::bind_method(D_METHOD("set_bullet_texture", "texture"), &BulletPattern::set_bullet_texture);
+	ClassDB::bind_method(D_METHOD("get_bullet_texture"), &BulletPattern::get_bullet_texture);
+
+	ClassDB::bind_method(D_METHOD("set_custom_data", "data"), &BulletPattern::set_custom_data);
+	ClassDB::bind_method(D_METHOD("get_custom_data"), &BulletPattern::get_custom_data);
+
+	ClassDB::bind_method(D_METHOD("set_sub_patterns", "patterns"), &BulletPattern::set_sub_patterns);
+	ClassDB::bind_method(D_METHOD("get_sub_patterns"), &BulletPattern::get_sub_patterns);
+
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "source", PROPERTY_HINT_MULTILINE_TEXT), "set_source", "get_source");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "bullet_path", PROPERTY_HINT_RESOURCE_TYPE, "BulletPath"), "set_bullet_path", "get_bullet_path");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "bullet_texture", PROPERTY_HINT_RESOURCE_TYPE, "BulletTexture"), "set_bullet_texture", "get_bullet_texture");
+	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "custom_data"), "set_custom_data", "get_custom_data");
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "sub_patterns", PROPERTY_HINT_ARRAY_TYPE, MAKE_RESOURCE_TYPE_HINT("BulletPattern")), "set_sub_patterns", "get_sub_patterns");
+}
+
+BulletPattern::BulletPattern() {
+	source = String();
+	bullet_path = Ref<BulletPath>();
+	bullet_texture = Ref<BulletTexture>();
+	custom_data = Dictionary();
+	sub_patterns = Array();
+	valid = true;
+}
+
+BulletPattern::~BulletPattern() {}
@@ -0,0 +1,80 @@
+#ifndef BULLETPATTERN_H
+#define BULLETPATTERN_H
+
+#include "bullet_path.h"
+#include "bullet_texture.h"
+
+#include "core/io/resource.h"
+#include "core/templates/local_vector.h"
+
+class BulletPattern : public Resource {
+	GDCLASS(BulletPattern, Resource);
+
+public:
+	enum Opcode : uint8_t {
+		OP_FIRE,
+		OP_WAIT,
+		OP_REPEAT,
+		OP_END,
+		OP_DIRECTION,
+		OP_TURN,
+		OP_AIM,
+		OP_SPEED,
+		OP_ACCEL,
+		OP_SHOTS,
+		OP_ARC,
+		OP_RADIUS,
+		OP_SUB,
+	};
+
+	struct Instruction {
+		Opcode op;
+		union {
+			int32_t i;
+			float f;
+		};
+	};
+
+private:
+	String source;
+	Ref<BulletPath> bullet_path;
+	Ref<BulletTexture> bullet_texture;
+	Dictionary custom_data;
+	Array sub_patterns;
+
+	LocalVector<Instruction> code;
+	bool valid;
+
+	void _compile();
+
+protected:
+	static void _bind_methods();
+
+public:
+	static const int MAX_INSTRUCTIONS_PER_TICK = 4096;
+
+	_FORCE_INLINE_ const LocalVector<Instruction> &get_code() const { return code; }
+	bool is_valid() const;
+
+	Error import_bulletml(const String &p_xml);
+
+	void set_source(const String &p_source);
+	String get_source() const;
+
+	void set_bullet_path(const Ref<BulletPath> &p_path);
+	Ref<BulletPath> get_bullet_path() const;
+
+	void set_bullet_texture(const Ref<BulletTexture> &p_texture);
+	Ref<BulletTexture> get_bullet_texture() const;
+
+	void set_custom_data(const Dictionary &p_data);
+	Dictionary get_custom_data() const;
+
+	void set_sub_patterns(const Array &p_patterns);
+	Array get_sub_patterns() const;
+
+	BulletPattern();
+	~BulletPattern();
+};
+
+#endif
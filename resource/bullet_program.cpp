@@ -0,0 +1,171 @@
+#include "bullet_program.h"
+
+void BulletProgram::_compile() {
+	code.clear();
+	valid = true;
+
+	Vector<String> lines = source.split("\n");
+	bool in_loop = false;
+	for (int l = 0; l < lines.size() && valid; l++) {
+		String line = lines[l].get_slicec('#', 0).strip_edges();
+		if (line.is_empty()) {
+			continue;
+		}
+		Vector<String> args = line.split_spaces();
+		String name = args[0].to_lower();
+		Instruction instruction;
+		instruction.i = 0;
+		instruction.f = 0.0;
+
+		//argument kinds: i = integer, f = number, d = degrees
+		String signature;
+		if (name == "wait") {
+			instruction.op = OP_WAIT;
+			signature = "i";
+		} else if (name == "stop") {
+			instruction.op = OP_SPEED;
+		} else if (name == "speed") {
+			instruction.op = OP_SPEED;
+			signature = "f";
+		} else if (name == "ramp") {
+			instruction.op = OP_RAMP;
+			signature = "fi";
+		} else if (name == "turn") {
+			instruction.op = OP_TURN;
+			signature = "d";
+		} else if (name == "aim") {
+			instruction.op = OP_AIM;
+		} else if (name == "path") {
+			instruction.op = OP_PATH;
+			signature = "i";
+		} else if (name == "repeat") {
+			instruction.op = OP_REPEAT;
+			signature = "i";
+		} else if (name == "end") {
+			instruction.op = OP_END;
+		} else if (name == "pop") {
+			instruction.op = OP_POP;
+		} else {
+			ERR_PRINT(vformat("BulletProgram line %d: unknown instruction '%s'.", l + 1, args[0]));
+			valid = false;
+			break;
+		}
+
+		if (args.size() != signature.length() + 1) {
+			ERR_PRINT(vformat("BulletProgram line %d: '%s' takes %d argument(s).", l + 1, name, signature.length()));
+			valid = false;
+			break;
+		}
+		for (int a = 0; a < signature.length(); a++) {
+			const String &arg = args[a + 1];
+			if (signature[a] == 'i') {
+				if (!arg.is_valid_int() || arg.to_int() < 0 || arg.to_int() > UINT16_MAX) {
+					ERR_PRINT(vformat("BulletProgram line %d: '%s' expects an integer between 0 and %d.", l + 1, name, UINT16_MAX));
+					valid = false;
+				}
+				instruction.i = arg.to_int();
+			} else {
+				if (!arg.is_valid_float()) {
+					ERR_PRINT(vformat("BulletProgram line %d: '%s' expects a number.", l + 1, name));
+					valid = false;
+				}
+				instruction.f = signature[a] == 'd' ? Math::deg_to_rad(arg.to_float()) : arg.to_float();
+			}
+		}
+
+		//bullets have room for a single loop
+		if (instruction.op == OP_REPEAT) {
+			if (in_loop) {
+				ERR_PRINT(vformat("BulletProgram line %d: loops can't be nested.", l + 1));
+				valid = false;
+			}
+			in_loop = true;
+		} else if (instruction.op == OP_END) {
+			if (!in_loop) {
+				ERR_PRINT(vformat("BulletProgram line %d: 'end' without 'repeat'.", l + 1));
+				valid = false;
+			}
+			in_loop = false;
+		} else if (instruction.op == OP_PATH && instruction.i >= (int)path_refs.size()) {
+			ERR_PRINT(vformat("BulletProgram line %d: there is no path %d.", l + 1, instruction.i));
+			valid = false;
+		}
+		code.push_back(instruction);
+	}
+
+	if (valid && in_loop) {
+		ERR_PRINT("BulletProgram: 'repeat' without 'end'.");
+		valid = false;
+	}
+	if (valid && code.size() > UINT16_MAX) {
+		ERR_PRINT("BulletProgram: program is too long.");
+		valid = false;
+	}
+	if (!valid) {
+		code.clear();
+	}
+}
+
+bool BulletProgram::is_valid() const {
+	return valid;
+}
+
+void BulletProgram::set_source(const String &p_source) {
+	source = p_source;
+	_compile();
+	emit_changed();
+}
+
+String BulletProgram::get_source() const {
+	return source;
+}
+
+void BulletProgram::set_target_group(const StringName &p_group) {
+	target_group = p_group;
+}
+
+StringName BulletProgram::get_target_group() const {
+	return target_group;
+}
+
+void BulletProgram::set_paths(const Array &p_paths) {
+	paths = p_paths;
+	path_refs.clear();
+	for (int i = 0; i < paths.size(); i++) {
+		path_refs.push_back(paths[i]);
+	}
+	//path indices are checked when compiling
+	_compile();
+	emit_changed();
+}
+
+Array BulletProgram::get_paths() const {
+	return paths;
+}
+
+void BulletProgram::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("is_valid"), &BulletProgram::is_valid);
+
+	ClassDB::bind_method(D_METHOD("set_source", "source"), &BulletProgram::set_source);
+	ClassDB::bind_method(D_METHOD("get_source"), &BulletProgram::get_source);
+
+	ClassDB::bind_method(D_METHOD("set_target_group", "group"), &BulletProgram::set_target_group);
+	ClassDB::bind_method(D_METHOD("get_target_group"), &BulletProgram::get_target_group);
+
+	ClassDB::bind_method(D_METHOD("set_paths", "paths"), &BulletProgram::set_paths);
+	ClassDB::bind_method(D_METHOD("get_paths"), &BulletProgram::get_paths);
+
+	//paths come first so they are loaded before the source that refers to them is compiled
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "paths", PROPERTY_HINT_ARRAY_TYPE, MAKE_RESOURCE_TYPE_HINT("BulletPath")), "set_paths", "get_paths");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "target_group"), "set_target_group", "get_target_group");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "source", PROPERTY_HINT_MULTILINE_TEXT), "set_source", "get_source");
+}
+
+BulletProgram::BulletProgram() {
+	source = String();
+	target_group = StringName();
+	paths = Array();
+	valid = true;
+}
+
+BulletProgram::~BulletProgram() {}
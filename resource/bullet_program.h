@@ -0,0 +1,65 @@
+#ifndef BULLETPROGRAM_H
+#define BULLETPROGRAM_H
+
+#include "bullet_path.h"
+
+#include "core/io/resource.h"
+#include "core/templates/local_vector.h"
+
+class BulletProgram : public Resource {
+	GDCLASS(BulletProgram, Resource);
+
+public:
+	enum Opcode : uint8_t {
+		OP_WAIT,
+		OP_SPEED,
+		OP_RAMP,
+		OP_TURN,
+		OP_AIM,
+		OP_PATH,
+		OP_REPEAT,
+		OP_END,
+		OP_POP,
+	};
+
+	struct Instruction {
+		Opcode op;
+		int32_t i;
+		float f;
+	};
+
+private:
+	String source;
+	StringName target_group;
+	Array paths;
+
+	LocalVector<Instruction> code;
+	LocalVector<Ref<BulletPath>> path_refs;
+	bool valid;
+
+	void _compile();
+
+protected:
+	static void _bind_methods();
+
+public:
+	static const int MAX_INSTRUCTIONS_PER_TICK = 64;
+
+	_FORCE_INLINE_ const LocalVector<Instruction> &get_code() const { return code; }
+	_FORCE_INLINE_ const Ref<BulletPath> &get_path_ref(int p_index) const { return path_refs[p_index]; }
+	bool is_valid() const;
+
+	void set_source(const String &p_source);
+	String get_source() const;
+
+	void set_target_group(const StringName &p_group);
+	StringName get_target_group() const;
+
+	void set_paths(const Array &p_paths);
+	Array get_paths() const;
+
+	BulletProgram();
+	~BulletProgram();
+};
+
+#endif
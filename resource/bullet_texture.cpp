@@ -6,6 +6,7 @@ void BulletTexture::_update_transform() {
 
 void BulletTexture::set_texture(const Ref<Texture2D> &p_texture) {
 	texture = p_texture;
+	emit_changed();
 }
 
 Ref<Texture2D> BulletTexture::get_texture() const {
@@ -14,6 +15,7 @@ Ref<Texture2D> BulletTexture::get_texture() const {
 
 void BulletTexture::set_modulate(const Color &p_color) {
 	modulate = p_color;
+	emit_changed();
 }
 
 Color BulletTexture::get_modulate() const {
@@ -22,6 +24,7 @@ Color BulletTexture::get_modulate() const {
 
 void BulletTexture::set_light_mask(int p_mask) {
 	light_mask = p_mask;
+	emit_changed();
 }
 
 int BulletTexture::get_light_mask() const {
@@ -30,14 +33,35 @@ int BulletTexture::get_light_mask() const {
 
 void BulletTexture::set_material(const Ref<Material> &p_material) {
 	material = p_material;
+	emit_changed();
 }
 
 Ref<Material> BulletTexture::get_material() const {
 	return material;
 }
 
+void BulletTexture::set_material_maps_atlas(bool p_enabled) {
+	material_maps_atlas = p_enabled;
+	emit_changed();
+}
+
+bool BulletTexture::get_material_maps_atlas() const {
+	return material_maps_atlas;
+}
+
+void BulletTexture::set_draw_layer(int p_layer) {
+	//bounded so the server can fold the layer and the bullet type into one draw index
+	draw_layer = CLAMP(p_layer, -4096, 4096);
+	emit_changed();
+}
+
+int BulletTexture::get_draw_layer() const {
+	return draw_layer;
+}
+
 void BulletTexture::set_collision_shape(const Ref<Shape2D> &p_shape) {
 	collision_shape = p_shape;
+	emit_changed();
 }
 
 Ref<Shape2D> BulletTexture::get_collision_shape() const {
@@ -46,6 +70,7 @@ Ref<Shape2D> BulletTexture::get_collision_shape() const {
 
 void BulletTexture::set_collision_mask(int p_mask) {
 	collision_mask = p_mask;
+	emit_changed();
 }
 
 int BulletTexture::get_collision_mask() const {
@@ -54,6 +79,7 @@ int BulletTexture::get_collision_mask() const {
 
 void BulletTexture::set_collision_detect_bodies(bool p_enabled) {
 	collision_detect_bodies = p_enabled;
+	emit_changed();
 }
 
 bool BulletTexture::get_collision_detect_bodies() const {
@@ -62,12 +88,48 @@ bool BulletTexture::get_collision_detect_bodies() const {
 
 void BulletTexture::set_collision_detect_areas(bool p_enabled) {
 	collision_detect_areas = p_enabled;
+	emit_changed();
 }
 
 bool BulletTexture::get_collision_detect_areas() const {
 	return collision_detect_areas;
 }
 
+void BulletTexture::set_cancel_layer(int p_layer) {
+	cancel_layer = p_layer;
+	emit_changed();
+}
+
+int BulletTexture::get_cancel_layer() const {
+	return cancel_layer;
+}
+
+void BulletTexture::set_cancel_mask(int p_mask) {
+	cancel_mask = p_mask;
+	emit_changed();
+}
+
+int BulletTexture::get_cancel_mask() const {
+	return cancel_mask;
+}
+
+void BulletTexture::set_cancel_radius(float p_radius) {
+	cancel_radius = MAX(p_radius, 0.0);
+	emit_changed();
+}
+
+float BulletTexture::get_cancel_radius() const {
+	return cancel_radius;
+}
+
+void BulletTexture::set_cosmetic(bool p_enabled) {
+	cosmetic = p_enabled;
+}
+
+bool BulletTexture::get_cosmetic() const {
+	return cosmetic;
+}
+
 void BulletTexture::set_face_direction(bool p_enabled) {
 	face_direction = p_enabled;
 }
@@ -113,6 +175,252 @@ Transform2D BulletTexture::get_transform() const {
 	return transform;
 }
 
+void BulletTexture::set_program(const Ref<BulletProgram> &p_program) {
+	program = p_program;
+}
+
+Ref<BulletProgram> BulletTexture::get_program() const {
+	return program;
+}
+
+void BulletTexture::set_animation_hframes(int p_frames) {
+	ERR_FAIL_COND(p_frames < 1);
+	animation_hframes = p_frames;
+	emit_changed();
+}
+
+int BulletTexture::get_animation_hframes() const {
+	return animation_hframes;
+}
+
+void BulletTexture::set_animation_vframes(int p_frames) {
+	ERR_FAIL_COND(p_frames < 1);
+	animation_vframes = p_frames;
+	emit_changed();
+}
+
+int BulletTexture::get_animation_vframes() const {
+	return animation_vframes;
+}
+
+void BulletTexture::set_animation_fps(float p_fps) {
+	animation_fps = MAX(p_fps, 0.0);
+	emit_changed();
+}
+
+float BulletTexture::get_animation_fps() const {
+	return animation_fps;
+}
+
+void BulletTexture::set_animation_loop(bool p_enabled) {
+	animation_loop = p_enabled;
+	emit_changed();
+}
+
+bool BulletTexture::get_animation_loop() const {
+	return animation_loop;
+}
+
+void BulletTexture::set_animation_start(AnimationStart p_start) {
+	animation_start = p_start;
+	emit_changed();
+}
+
+BulletTexture::AnimationStart BulletTexture::get_animation_start() const {
+	return animation_start;
+}
+
+void BulletTexture::set_animation_start_frame(int p_frame) {
+	ERR_FAIL_COND(p_frame < 0);
+	animation_start_frame = p_frame;
+	emit_changed();
+}
+
+int BulletTexture::get_animation_start_frame() const {
+	return animation_start_frame;
+}
+
+Rect2 BulletTexture::get_frame_rect(int p_frame) const {
+	ERR_FAIL_COND_V(!texture.is_valid(), Rect2());
+	Size2 frame_size = texture->get_size() / Size2(animation_hframes, animation_vframes);
+	int frame = p_frame % get_animation_frame_count();
+	return Rect2(Vector2(frame % animation_hframes, frame / animation_hframes) * frame_size, frame_size);
+}
+
+void BulletTexture::set_pop_effect_duration(float p_seconds) {
+	pop_effect_duration = MAX(p_seconds, 0.0);
+	emit_changed();
+}
+
+float BulletTexture::get_pop_effect_duration() const {
+	return pop_effect_duration;
+}
+
+void BulletTexture::set_pop_effect_reasons(int p_reasons) {
+	pop_effect_reasons = p_reasons;
+	emit_changed();
+}
+
+int BulletTexture::get_pop_effect_reasons() const {
+	return pop_effect_reasons;
+}
+
+void BulletTexture::set_pop_effect_fade(bool p_enabled) {
+	pop_effect_fade = p_enabled;
+	emit_changed();
+}
+
+bool BulletTexture::get_pop_effect_fade() const {
+	return pop_effect_fade;
+}
+
+void BulletTexture::set_pop_effect_scale(float p_scale) {
+	pop_effect_scale = p_scale;
+	emit_changed();
+}
+
+float BulletTexture::get_pop_effect_scale() const {
+	return pop_effect_scale;
+}
+
+void BulletTexture::set_pop_effect_texture(const Ref<Texture2D> &p_texture) {
+	pop_effect_texture = p_texture;
+	emit_changed();
+}
+
+Ref<Texture2D> BulletTexture::get_pop_effect_texture() const {
+	return pop_effect_texture;
+}
+
+void BulletTexture::set_pop_effect_hframes(int p_frames) {
+	ERR_FAIL_COND(p_frames < 1);
+	pop_effect_hframes = p_frames;
+	emit_changed();
+}
+
+int BulletTexture::get_pop_effect_hframes() const {
+	return pop_effect_hframes;
+}
+
+void BulletTexture::set_pop_effect_vframes(int p_frames) {
+	ERR_FAIL_COND(p_frames < 1);
+	pop_effect_vframes = p_frames;
+	emit_changed();
+}
+
+int BulletTexture::get_pop_effect_vframes() const {
+	return pop_effect_vframes;
+}
+
+void BulletTexture::set_emit_texture(const Ref<BulletTexture> &p_texture) {
+	//chains are kept acyclic, so walking one always ends, and textures in it can't keep each other alive
+	for (const BulletTexture *texture = p_texture.ptr(); texture; texture = texture->emit_texture.ptr()) {
+		ERR_FAIL_COND_MSG(texture == this, "A BulletTexture can't emit bullets of its own type, directly or through the textures it emits.");
+	}
+	emit_texture = p_texture;
+}
+
+Ref<BulletTexture> BulletTexture::get_emit_texture() const {
+	return emit_texture;
+}
+
+void BulletTexture::set_emit_path(const Ref<BulletPath> &p_path) {
+	emit_path = p_path;
+}
+
+Ref<BulletPath> BulletTexture::get_emit_path() const {
+	return emit_path;
+}
+
+void BulletTexture::set_emit_count(int p_count) {
+	ERR_FAIL_COND(p_count < 0);
+	emit_count = p_count;
+}
+
+int BulletTexture::get_emit_count() const {
+	return emit_count;
+}
+
+void BulletTexture::set_emit_arc_width(float p_radians) {
+	emit_arc_width = p_radians;
+}
+
+float BulletTexture::get_emit_arc_width() const {
+	return emit_arc_width;
+}
+
+void BulletTexture::set_emit_arc_width_degrees(float p_degrees) {
+	emit_arc_width = Math::deg_to_rad(p_degrees);
+}
+
+float BulletTexture::get_emit_arc_width_degrees() const {
+	return Math::rad_to_deg(emit_arc_width);
+}
+
+void BulletTexture::set_emit_arc_rotation(float p_radians) {
+	emit_arc_rotation = p_radians;
+}
+
+float BulletTexture::get_emit_arc_rotation() const {
+	return emit_arc_rotation;
+}
+
+void BulletTexture::set_emit_arc_rotation_degrees(float p_degrees) {
+	emit_arc_rotation = Math::deg_to_rad(p_degrees);
+}
+
+float BulletTexture::get_emit_arc_rotation_degrees() const {
+	return Math::rad_to_deg(emit_arc_rotation);
+}
+
+void BulletTexture::set_emit_relative(bool p_enabled) {
+	emit_relative = p_enabled;
+}
+
+bool BulletTexture::get_emit_relative() const {
+	return emit_relative;
+}
+
+void BulletTexture::set_emit_on_pop(int p_reasons) {
+	emit_on_pop = p_reasons;
+}
+
+int BulletTexture::get_emit_on_pop() const {
+	return emit_on_pop;
+}
+
+void BulletTexture::set_emit_interval(float p_seconds) {
+	emit_interval = MAX(p_seconds, 0.0);
+}
+
+float BulletTexture::get_emit_interval() const {
+	return emit_interval;
+}
+
+void BulletTexture::set_payload_ints(const PackedInt32Array &p_values) {
+	ERR_FAIL_COND_MSG(p_values.size() > PAYLOAD_SLOTS, vformat("Bullets only have %d int payload slots.", PAYLOAD_SLOTS));
+	payload_ints = p_values;
+	for (int i = 0; i < PAYLOAD_SLOTS; i++) {
+		payload_int_defaults[i] = i < p_values.size() ? p_values[i] : 0;
+	}
+}
+
+PackedInt32Array BulletTexture::get_payload_ints() const {
+	return payload_ints;
+}
+
+void BulletTexture::set_payload_floats(const PackedFloat32Array &p_values) {
+	ERR_FAIL_COND_MSG(p_values.size() > PAYLOAD_SLOTS, vformat("Bullets only have %d float payload slots.", PAYLOAD_SLOTS));
+	payload_floats = p_values;
+	for (int i = 0; i < PAYLOAD_SLOTS; i++) {
+		payload_float_defaults[i] = i < p_values.size() ? p_values[i] : 0.0;
+	}
+}
+
+PackedFloat32Array BulletTexture::get_payload_floats() const {
+	return payload_floats;
+}
+
 void BulletTexture::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_texture", "texture"), &BulletTexture::set_texture);
 	ClassDB::bind_method(D_METHOD("get_texture"), &BulletTexture::get_texture);
@@ -126,6 +434,12 @@ void BulletTexture::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_material", "material"), &BulletTexture::set_material);
 	ClassDB::bind_method(D_METHOD("get_material"), &BulletTexture::get_material);
 
+	ClassDB::bind_method(D_METHOD("set_material_maps_atlas", "enabled"), &BulletTexture::set_material_maps_atlas);
+	ClassDB::bind_method(D_METHOD("get_material_maps_atlas"), &BulletTexture::get_material_maps_atlas);
+
+	ClassDB::bind_method(D_METHOD("set_draw_layer", "layer"), &BulletTexture::set_draw_layer);
+	ClassDB::bind_method(D_METHOD("get_draw_layer"), &BulletTexture::get_draw_layer);
+
 	ClassDB::bind_method(D_METHOD("set_collision_shape", "collision_shape"), &BulletTexture::set_collision_shape);
 	ClassDB::bind_method(D_METHOD("get_collision_shape"), &BulletTexture::get_collision_shape);
 
@@ -138,6 +452,18 @@ void BulletTexture::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_collision_detect_areas", "enabled"), &BulletTexture::set_collision_detect_areas);
 	ClassDB::bind_method(D_METHOD("get_collision_detect_areas"), &BulletTexture::get_collision_detect_areas);
 
+	ClassDB::bind_method(D_METHOD("set_cancel_layer", "layer"), &BulletTexture::set_cancel_layer);
+	ClassDB::bind_method(D_METHOD("get_cancel_layer"), &BulletTexture::get_cancel_layer);
+
+	ClassDB::bind_method(D_METHOD("set_cancel_mask", "mask"), &BulletTexture::set_cancel_mask);
+	ClassDB::bind_method(D_METHOD("get_cancel_mask"), &BulletTexture::get_cancel_mask);
+
+	ClassDB::bind_method(D_METHOD("set_cancel_radius", "radius"), &BulletTexture::set_cancel_radius);
+	ClassDB::bind_method(D_METHOD("get_cancel_radius"), &BulletTexture::get_cancel_radius);
+
+	ClassDB::bind_method(D_METHOD("set_cosmetic", "enabled"), &BulletTexture::set_cosmetic);
+	ClassDB::bind_method(D_METHOD("get_cosmetic"), &BulletTexture::get_cosmetic);
+
 	ClassDB::bind_method(D_METHOD("set_face_direction", "enabled"), &BulletTexture::set_face_direction);
 	ClassDB::bind_method(D_METHOD("get_face_direction"), &BulletTexture::get_face_direction);
 
@@ -153,21 +479,150 @@ void BulletTexture::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_transform", "transform"), &BulletTexture::set_transform);
 	ClassDB::bind_method(D_METHOD("get_transform"), &BulletTexture::get_transform);
 
+	ClassDB::bind_method(D_METHOD("set_program", "program"), &BulletTexture::set_program);
+	ClassDB::bind_method(D_METHOD("get_program"), &BulletTexture::get_program);
+
+	ClassDB::bind_method(D_METHOD("set_animation_hframes", "frames"), &BulletTexture::set_animation_hframes);
+	ClassDB::bind_method(D_METHOD("get_animation_hframes"), &BulletTexture::get_animation_hframes);
+
+	ClassDB::bind_method(D_METHOD("set_animation_vframes", "frames"), &BulletTexture::set_animation_vframes);
+	ClassDB::bind_method(D_METHOD("get_animation_vframes"), &BulletTexture::get_animation_vframes);
+
+	ClassDB::bind_method(D_METHOD("set_animation_fps", "fps"), &BulletTexture::set_animation_fps);
+	ClassDB::bind_method(D_METHOD("get_animation_fps"), &BulletTexture::get_animation_fps);
+
+	ClassDB::bind_method(D_METHOD("set_animation_loop", "enabled"), &BulletTexture::set_animation_loop);
+	ClassDB::bind_method(D_METHOD("get_animation_loop"), &BulletTexture::get_animation_loop);
+
+	ClassDB::bind_method(D_METHOD("set_animation_start", "start"), &BulletTexture::set_animation_start);
+	ClassDB::bind_method(D_METHOD("get_animation_start"), &BulletTexture::get_animation_start);
+
+	ClassDB::bind_method(D_METHOD("set_animation_start_frame", "frame"), &BulletTexture::set_animation_start_frame);
+	ClassDB::bind_method(D_METHOD("get_animation_start_frame"), &BulletTexture::get_animation_start_frame);
+
+	ClassDB::bind_method(D_METHOD("get_frame_rect", "frame"), &BulletTexture::get_frame_rect);
+
+	ClassDB::bind_method(D_METHOD("set_pop_effect_duration", "seconds"), &BulletTexture::set_pop_effect_duration);
+	ClassDB::bind_method(D_METHOD("get_pop_effect_duration"), &BulletTexture::get_pop_effect_duration);
+
+	ClassDB::bind_method(D_METHOD("set_pop_effect_reasons", "reasons"), &BulletTexture::set_pop_effect_reasons);
+	ClassDB::bind_method(D_METHOD("get_pop_effect_reasons"), &BulletTexture::get_pop_effect_reasons);
+
+	ClassDB::bind_method(D_METHOD("set_pop_effect_fade", "enabled"), &BulletTexture::set_pop_effect_fade);
+	ClassDB::bind_method(D_METHOD("get_pop_effect_fade"), &BulletTexture::get_pop_effect_fade);
+
+	ClassDB::bind_method(D_METHOD("set_pop_effect_scale", "scale"), &BulletTexture::set_pop_effect_scale);
+	ClassDB::bind_method(D_METHOD("get_pop_effect_scale"), &BulletTexture::get_pop_effect_scale);
+
+	ClassDB::bind_method(D_METHOD("set_pop_effect_texture", "texture"), &BulletTexture::set_pop_effect_texture);
+	ClassDB::bind_method(D_METHOD("get_pop_effect_texture"), &BulletTexture::get_pop_effect_texture);
+
+	ClassDB::bind_method(D_METHOD("set_pop_effect_hframes", "frames"), &BulletTexture::set_pop_effect_hframes);
+	ClassDB::bind_method(D_METHOD("get_pop_effect_hframes"), &BulletTexture::get_pop_effect_hframes);
+
+	ClassDB::bind_method(D_METHOD("set_pop_effect_vframes", "frames"), &BulletTexture::set_pop_effect_vframes);
+	ClassDB::bind_method(D_METHOD("get_pop_effect_vframes"), &BulletTexture::get_pop_effect_vframes);
+
+	ClassDB::bind_method(D_METHOD("set_emit_texture", "texture"), &BulletTexture::set_emit_texture);
+	ClassDB::bind_method(D_METHOD("get_emit_texture"), &BulletTexture::get_emit_texture);
+
+	ClassDB::bind_method(D_METHOD("set_emit_path", "path"), &BulletTexture::set_emit_path);
+	ClassDB::bind_method(D_METHOD("get_emit_path"), &BulletTexture::get_emit_path);
+
+	ClassDB::bind_method(D_METHOD("set_emit_count", "count"), &BulletTexture::set_emit_count);
+	ClassDB::bind_method(D_METHOD("get_emit_count"), &BulletTexture::get_emit_count);
+
+	ClassDB::bind_method(D_METHOD("set_emit_arc_width", "radians"), &BulletTexture::set_emit_arc_width);
+	ClassDB::bind_method(D_METHOD("get_emit_arc_width"), &BulletTexture::get_emit_arc_width);
+
+	ClassDB::bind_method(D_METHOD("set_emit_arc_width_degrees", "degrees"), &BulletTexture::set_emit_arc_width_degrees);
+	ClassDB::bind_method(D_METHOD("get_emit_arc_width_degrees"), &BulletTexture::get_emit_arc_width_degrees);
+
+	ClassDB::bind_method(D_METHOD("set_emit_arc_rotation", "radians"), &BulletTexture::set_emit_arc_rotation);
+	ClassDB::bind_method(D_METHOD("get_emit_arc_rotation"), &BulletTexture::get_emit_arc_rotation);
+
+	ClassDB::bind_method(D_METHOD("set_emit_arc_rotation_degrees", "degrees"), &BulletTexture::set_emit_arc_rotation_degrees);
+	ClassDB::bind_method(D_METHOD("get_emit_arc_rotation_degrees"), &BulletTexture::get_emit_arc_rotation_degrees);
+
+	ClassDB::bind_method(D_METHOD("set_emit_relative", "enabled"), &BulletTexture::set_emit_relative);
+	ClassDB::bind_method(D_METHOD("get_emit_relative"), &BulletTexture::get_emit_relative);
+
+	ClassDB::bind_method(D_METHOD("set_emit_on_pop", "reasons"), &BulletTexture::set_emit_on_pop);
+	ClassDB::bind_method(D_METHOD("get_emit_on_pop"), &BulletTexture::get_emit_on_pop);
+
+	ClassDB::bind_method(D_METHOD("set_emit_interval", "seconds"), &BulletTexture::set_emit_interval);
+	ClassDB::bind_method(D_METHOD("get_emit_interval"), &BulletTexture::get_emit_interval);
+
+	ClassDB::bind_method(D_METHOD("set_payload_ints", "values"), &BulletTexture::set_payload_ints);
+	ClassDB::bind_method(D_METHOD("get_payload_ints"), &BulletTexture::get_payload_ints);
+
+	ClassDB::bind_method(D_METHOD("set_payload_floats", "values"), &BulletTexture::set_payload_floats);
+	ClassDB::bind_method(D_METHOD("get_payload_floats"), &BulletTexture::get_payload_floats);
+
 	ADD_GROUP("Appearance", "");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "texture", PROPERTY_HINT_RESOURCE_TYPE, "Texture2D"), "set_texture", "get_texture");
 	ADD_PROPERTY(PropertyInfo(Variant::COLOR, "modulate"), "set_modulate", "get_modulate");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "light_mask", PROPERTY_HINT_LAYERS_2D_RENDER), "set_light_mask", "get_light_mask");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "material", PROPERTY_HINT_RESOURCE_TYPE, "Material"), "set_material", "get_material");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "material_maps_atlas"), "set_material_maps_atlas", "get_material_maps_atlas");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "draw_layer", PROPERTY_HINT_RANGE, "-4096,4096,1"), "set_draw_layer", "get_draw_layer");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cosmetic"), "set_cosmetic", "get_cosmetic");
+	ADD_GROUP("Animation", "animation_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "animation_hframes", PROPERTY_HINT_RANGE, "1,64,1,or_greater"), "set_animation_hframes", "get_animation_hframes");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "animation_vframes", PROPERTY_HINT_RANGE, "1,64,1,or_greater"), "set_animation_vframes", "get_animation_vframes");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "animation_fps", PROPERTY_HINT_RANGE, "0,60,0.1,or_greater"), "set_animation_fps", "get_animation_fps");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "animation_loop"), "set_animation_loop", "get_animation_loop");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "animation_start", PROPERTY_HINT_ENUM, "Fixed,Random,Staggered"), "set_animation_start", "get_animation_start");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "animation_start_frame", PROPERTY_HINT_RANGE, "0,256,1,or_greater"), "set_animation_start_frame", "get_animation_start_frame");
+	ADD_GROUP("Pop Effect", "pop_effect_");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "pop_effect_duration", PROPERTY_HINT_RANGE, "0,2,0.01,or_greater,suffix:s"), "set_pop_effect_duration", "get_pop_effect_duration");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "pop_effect_reasons", PROPERTY_HINT_FLAGS, "Out Of Bounds,Server Lifetime,Path Lifetime,Collide,Requested,Cancelled"), "set_pop_effect_reasons", "get_pop_effect_reasons");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "pop_effect_fade"), "set_pop_effect_fade", "get_pop_effect_fade");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "pop_effect_scale", PROPERTY_HINT_RANGE, "0,4,0.01,or_greater"), "set_pop_effect_scale", "get_pop_effect_scale");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "pop_effect_texture", PROPERTY_HINT_RESOURCE_TYPE, "Texture2D"), "set_pop_effect_texture", "get_pop_effect_texture");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "pop_effect_hframes", PROPERTY_HINT_RANGE, "1,64,1,or_greater"), "set_pop_effect_hframes", "get_pop_effect_hframes");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "pop_effect_vframes", PROPERTY_HINT_RANGE, "1,64,1,or_greater"), "set_pop_effect_vframes", "get_pop_effect_vframes");
 	ADD_GROUP("Collision", "collision_");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "collision_shape", PROPERTY_HINT_RESOURCE_TYPE, "Shape2D"), "set_collision_shape", "get_collision_shape");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_mask", PROPERTY_HINT_LAYERS_2D_PHYSICS), "set_collision_mask", "get_collision_mask");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_detect_bodies"), "set_collision_detect_bodies", "get_collision_detect_bodies");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_detect_areas"), "set_collision_detect_areas", "get_collision_detect_areas");
+	ADD_GROUP("Cancel", "cancel_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "cancel_layer", PROPERTY_HINT_LAYERS_2D_PHYSICS), "set_cancel_layer", "get_cancel_layer");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "cancel_mask", PROPERTY_HINT_LAYERS_2D_PHYSICS), "set_cancel_mask", "get_cancel_mask");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cancel_radius", PROPERTY_HINT_RANGE, "0,64,0.1,or_greater,suffix:px"), "set_cancel_radius", "get_cancel_radius");
 	ADD_GROUP("Transform", "");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "face_direction"), "set_face_direction", "get_face_direction");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "rotation", PROPERTY_HINT_RANGE, "", PROPERTY_USAGE_NO_EDITOR), "set_rotation", "get_rotation");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "rotation_degrees", PROPERTY_HINT_RANGE, "-360,360,0.1,or_less,or_greater", PROPERTY_USAGE_EDITOR), "set_rotation_degrees", "get_rotation_degrees");
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "scale"), "set_scale", "get_scale");
+	ADD_GROUP("Behavior", "");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "program", PROPERTY_HINT_RESOURCE_TYPE, "BulletProgram"), "set_program", "get_program");
+	ADD_GROUP("Emission", "emit_");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "emit_texture", PROPERTY_HINT_RESOURCE_TYPE, "BulletTexture"), "set_emit_texture", "get_emit_texture");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "emit_path", PROPERTY_HINT_RESOURCE_TYPE, "BulletPath"), "set_emit_path", "get_emit_path");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "emit_count", PROPERTY_HINT_RANGE, "0,256,1,or_greater"), "set_emit_count", "get_emit_count");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "emit_arc_width", PROPERTY_HINT_RANGE, "", PROPERTY_USAGE_NO_EDITOR), "set_emit_arc_width", "get_emit_arc_width");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "emit_arc_width_degrees", PROPERTY_HINT_RANGE, "0,360,0.1", PROPERTY_USAGE_EDITOR), "set_emit_arc_width_degrees", "get_emit_arc_width_degrees");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "emit_arc_rotation", PROPERTY_HINT_RANGE, "", PROPERTY_USAGE_NO_EDITOR), "set_emit_arc_rotation", "get_emit_arc_rotation");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "emit_arc_rotation_degrees", PROPERTY_HINT_RANGE, "-360,360,0.1,or_less,or_greater", PROPERTY_USAGE_EDITOR), "set_emit_arc_rotation_degrees", "get_emit_arc_rotation_degrees");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "emit_relative"), "set_emit_relative", "get_emit_relative");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "emit_on_pop", PROPERTY_HINT_FLAGS, "Out Of Bounds,Server Lifetime,Path Lifetime,Collide,Requested,Cancelled"), "set_emit_on_pop", "get_emit_on_pop");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "emit_interval", PROPERTY_HINT_RANGE, "0,10,0.001,or_greater,suffix:s"), "set_emit_interval", "get_emit_interval");
+	ADD_GROUP("Payload", "payload_");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "payload_ints"), "set_payload_ints", "get_payload_ints");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "payload_floats"), "set_payload_floats", "get_payload_floats");
+
+	BIND_ENUM_CONSTANT(POP_OUT_OF_BOUNDS);
+	BIND_ENUM_CONSTANT(POP_LIFETIME_SERVER);
+	BIND_ENUM_CONSTANT(POP_LIFETIME_BULLET);
+	BIND_ENUM_CONSTANT(POP_COLLIDE);
+	BIND_ENUM_CONSTANT(POP_REQUESTED);
+	BIND_ENUM_CONSTANT(POP_CANCELLED);
+
+	BIND_ENUM_CONSTANT(ANIMATION_START_FIXED);
+	BIND_ENUM_CONSTANT(ANIMATION_START_RANDOM);
+	BIND_ENUM_CONSTANT(ANIMATION_START_STAGGERED);
 }
 
 BulletTexture::BulletTexture() {
@@ -175,13 +630,45 @@ BulletTexture::BulletTexture() {
 	modulate = Color(1, 1, 1, 1);
 	light_mask = 1;
 	material = Ref<Material>();
+	material_maps_atlas = false;
+	draw_layer = 0;
 	collision_shape = Ref<Shape2D>();
 	collision_mask = 1;
 	collision_detect_bodies = true;
 	collision_detect_areas = true;
+	cancel_layer = 0;
+	cancel_mask = 0;
+	cancel_radius = 4.0;
+	cosmetic = false;
 	face_direction = false;
 	rotation = 0.0;
 	scale = Vector2(1, 1);
+	program = Ref<BulletProgram>();
+	animation_hframes = 1;
+	animation_vframes = 1;
+	animation_fps = 0.0;
+	animation_loop = true;
+	animation_start = ANIMATION_START_FIXED;
+	animation_start_frame = 0;
+	pop_effect_duration = 0.0;
+	pop_effect_reasons = POP_LIFETIME_SERVER | POP_LIFETIME_BULLET | POP_COLLIDE | POP_REQUESTED | POP_CANCELLED;
+	pop_effect_fade = true;
+	pop_effect_scale = 1.0;
+	pop_effect_texture = Ref<Texture2D>();
+	pop_effect_hframes = 1;
+	pop_effect_vframes = 1;
+	emit_texture = Ref<BulletTexture>();
+	emit_path = Ref<BulletPath>();
+	emit_count = 0;
+	emit_arc_width = Math::TAU;
+	emit_arc_rotation = 0.0;
+	emit_relative = true;
+	emit_on_pop = 0;
+	emit_interval = 0.0;
+	for (int i = 0; i < PAYLOAD_SLOTS; i++) {
+		payload_int_defaults[i] = 0;
+		payload_float_defaults[i] = 0.0;
+	}
 }
 
 BulletTexture::~BulletTexture() {
@@ -1,6 +1,8 @@
 #ifndef BULLETTEXTURE_H
 #define BULLETTEXTURE_H
 
+#include "bullet_program.h"
+
 #include "core/io/resource.h"
 #include "core/math/transform_2d.h"
 #include "scene/resources/material.h"
@@ -10,19 +12,76 @@
 class BulletTexture : public Resource {
 	GDCLASS(BulletTexture, Resource);
 
+public:
+	//one bit per reason a bullet can pop, in the order of Bullet::State
+	enum PopReason {
+		POP_OUT_OF_BOUNDS = 1,
+		POP_LIFETIME_SERVER = 2,
+		POP_LIFETIME_BULLET = 4,
+		POP_COLLIDE = 8,
+		POP_REQUESTED = 16,
+		POP_CANCELLED = 32,
+	};
+
+	//where in the sprite sheet each bullet starts its animation
+	enum AnimationStart {
+		ANIMATION_START_FIXED,
+		ANIMATION_START_RANDOM,
+		ANIMATION_START_STAGGERED,
+	};
+
+	//typed values every bullet carries, for per-bullet state such as damage
+	static const int PAYLOAD_SLOTS = 4;
+
 private:
 	Ref<Texture2D> texture;
 	Color modulate;
 	int light_mask;
 	Ref<Material> material;
+	bool material_maps_atlas;
+	int draw_layer;
 	Ref<Shape2D> collision_shape;
 	int collision_mask;
 	bool collision_detect_bodies;
 	bool collision_detect_areas;
+	int cancel_layer;
+	int cancel_mask;
+	float cancel_radius;
+	bool cosmetic;
 	bool face_direction;
 	float rotation;
 	Vector2 scale;
 	Transform2D transform;
+	Ref<BulletProgram> program;
+
+	int animation_hframes;
+	int animation_vframes;
+	float animation_fps;
+	bool animation_loop;
+	AnimationStart animation_start;
+	int animation_start_frame;
+
+	float pop_effect_duration;
+	int pop_effect_reasons;
+	bool pop_effect_fade;
+	float pop_effect_scale;
+	Ref<Texture2D> pop_effect_texture;
+	int pop_effect_hframes;
+	int pop_effect_vframes;
+
+	Ref<BulletTexture> emit_texture;
+	Ref<BulletPath> emit_path;
+	int emit_count;
+	float emit_arc_width;
+	float emit_arc_rotation;
+	bool emit_relative;
+	int emit_on_pop;
+	float emit_interval;
+
+	PackedInt32Array payload_ints;
+	PackedFloat32Array payload_floats;
+	int32_t payload_int_defaults[PAYLOAD_SLOTS];
+	float payload_float_defaults[PAYLOAD_SLOTS];
 
 	void _update_transform();
 
@@ -42,6 +101,12 @@ public:
 	void set_material(const Ref<Material> &p_material);
 	Ref<Material> get_material() const;
 
+	void set_material_maps_atlas(bool p_enabled);
+	bool get_material_maps_atlas() const;
+
+	void set_draw_layer(int p_layer);
+	int get_draw_layer() const;
+
 	void set_collision_shape(const Ref<Shape2D> &p_shape);
 	Ref<Shape2D> get_collision_shape() const;
 
@@ -54,6 +119,18 @@ public:
 	void set_collision_detect_areas(bool p_enabled);
 	bool get_collision_detect_areas() const;
 
+	void set_cancel_layer(int p_layer);
+	int get_cancel_layer() const;
+
+	void set_cancel_mask(int p_mask);
+	int get_cancel_mask() const;
+
+	void set_cancel_radius(float p_radius);
+	float get_cancel_radius() const;
+
+	void set_cosmetic(bool p_enabled);
+	bool get_cosmetic() const;
+
 	void set_face_direction(bool p_enabled);
 	bool get_face_direction() const;
 
@@ -69,8 +146,100 @@ public:
 	void set_transform(Transform2D p_xform);
 	Transform2D get_transform() const;
 
+	void set_program(const Ref<BulletProgram> &p_program);
+	Ref<BulletProgram> get_program() const;
+
+	void set_animation_hframes(int p_frames);
+	int get_animation_hframes() const;
+
+	void set_animation_vframes(int p_frames);
+	int get_animation_vframes() const;
+
+	void set_animation_fps(float p_fps);
+	float get_animation_fps() const;
+
+	void set_animation_loop(bool p_enabled);
+	bool get_animation_loop() const;
+
+	void set_animation_start(AnimationStart p_start);
+	AnimationStart get_animation_start() const;
+
+	void set_animation_start_frame(int p_frame);
+	int get_animation_start_frame() const;
+
+	_FORCE_INLINE_ int get_animation_frame_count() const { return animation_hframes * animation_vframes; }
+	Rect2 get_frame_rect(int p_frame) const;
+
+	_FORCE_INLINE_ bool has_pop_effect(int p_reason) const { return pop_effect_duration > 0.0 && (pop_effect_reasons & p_reason); }
+
+	void set_pop_effect_duration(float p_seconds);
+	float get_pop_effect_duration() const;
+
+	void set_pop_effect_reasons(int p_reasons);
+	int get_pop_effect_reasons() const;
+
+	void set_pop_effect_fade(bool p_enabled);
+	bool get_pop_effect_fade() const;
+
+	void set_pop_effect_scale(float p_scale);
+	float get_pop_effect_scale() const;
+
+	void set_pop_effect_texture(const Ref<Texture2D> &p_texture);
+	Ref<Texture2D> get_pop_effect_texture() const;
+
+	void set_pop_effect_hframes(int p_frames);
+	int get_pop_effect_hframes() const;
+
+	void set_pop_effect_vframes(int p_frames);
+	int get_pop_effect_vframes() const;
+
+	_FORCE_INLINE_ bool can_emit() const { return emit_count > 0 && emit_texture.is_valid() && emit_path.is_valid(); }
+	_FORCE_INLINE_ bool emits_on_pop(int p_reason) const { return (emit_on_pop & p_reason) && can_emit(); }
+	_FORCE_INLINE_ bool emits_on_timer() const { return emit_interval > 0.0 && can_emit(); }
+
+	void set_emit_texture(const Ref<BulletTexture> &p_texture);
+	Ref<BulletTexture> get_emit_texture() const;
+
+	void set_emit_path(const Ref<BulletPath> &p_path);
+	Ref<BulletPath> get_emit_path() const;
+
+	void set_emit_count(int p_count);
+	int get_emit_count() const;
+
+	void set_emit_arc_width(float p_radians);
+	float get_emit_arc_width() const;
+
+	void set_emit_arc_width_degrees(float p_degrees);
+	float get_emit_arc_width_degrees() const;
+
+	void set_emit_arc_rotation(float p_radians);
+	float get_emit_arc_rotation() const;
+
+	void set_emit_arc_rotation_degrees(float p_degrees);
+	float get_emit_arc_rotation_degrees() const;
+
+	void set_emit_relative(bool p_enabled);
+	bool get_emit_relative() const;
+
+	void set_emit_on_pop(int p_reasons);
+	int get_emit_on_pop() const;
+
+	void set_emit_interval(float p_seconds);
+	float get_emit_interval() const;
+
+	_FORCE_INLINE_ int32_t get_default_payload_int(int p_slot) const { return payload_int_defaults[p_slot]; }
+	_FORCE_INLINE_ float get_default_payload_float(int p_slot) const { return payload_float_defaults[p_slot]; }
+
+	void set_payload_ints(const PackedInt32Array &p_values);
+	PackedInt32Array get_payload_ints() const;
+
+	void set_payload_floats(const PackedFloat32Array &p_values);
+	PackedFloat32Array get_payload_floats() const;
+
 	BulletTexture();
 	~BulletTexture();
 };
 
+VARIANT_ENUM_CAST(BulletTexture::PopReason);
+VARIANT_ENUM_CAST(BulletTexture::AnimationStart);
 #endif
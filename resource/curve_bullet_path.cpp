@@ -0,0 +1,286 @@
+#include "curve_bullet_path.h"
+
+void CurveBulletPath::_bake() {
+    //heading and displacement are integrated with the trapezoid rule, in the path's own frame
+    int samples = curve_duration > 0 ? bake_resolution : 0;
+    float interval = samples > 0 ? curve_duration/samples : 0;
+    baked_speed.resize(samples + 1);
+    baked_heading.resize(samples + 1);
+    baked_displacement.resize(samples + 1);
+    float *speed = baked_speed.ptrw();
+    float *heading = baked_heading.ptrw();
+    Vector2 *displacement = baked_displacement.ptrw();
+
+    speed[0] = init_speed*_sample_curve(speed_curve, 0);
+    heading[0] = 0;
+    displacement[0] = Vector2();
+    float turn = turn_rate*_sample_curve(turn_curve, 0);
+    for (int i = 1; i <= samples; i++) {
+        float next_turn = turn_rate*_sample_curve(turn_curve, i*interval);
+        speed[i] = init_speed*_sample_curve(speed_curve, i*interval);
+        heading[i] = heading[i - 1] + interval*(turn + next_turn)/2;
+        displacement[i] = displacement[i - 1] + interval*(Vector2::from_angle(heading[i - 1])*speed[i - 1] + Vector2::from_angle(heading[i])*speed[i])/2;
+        turn = next_turn;
+    }
+    baked_end_turn = turn;
+}
+
+void CurveBulletPath::_set_curve(Ref<Curve> &r_curve, const Ref<Curve> &p_curve) {
+    //reference counted, since one curve may drive both speed and turn rate
+    if (!tracks_curves) {
+        tracks_curves = true;
+        if (speed_curve.is_valid()) {
+            speed_curve->connect_changed(callable_mp(this, &CurveBulletPath::_bake), CONNECT_REFERENCE_COUNTED);
+        }
+        if (turn_curve.is_valid()) {
+            turn_curve->connect_changed(callable_mp(this, &CurveBulletPath::_bake), CONNECT_REFERENCE_COUNTED);
+        }
+    }
+    if (r_curve.is_valid()) {
+        r_curve->disconnect_changed(callable_mp(this, &CurveBulletPath::_bake));
+    }
+    r_curve = p_curve;
+    if (r_curve.is_valid()) {
+        r_curve->connect_changed(callable_mp(this, &CurveBulletPath::_bake), CONNECT_REFERENCE_COUNTED);
+    }
+    _bake();
+}
+
+float CurveBulletPath::_sample_curve(const Ref<Curve> &p_curve, float p_time) const {
+    if (p_curve.is_null()) {
+        return 1.0;
+    }
+    float weight = curve_duration > 0 ? CLAMP(p_time/curve_duration, 0, 1) : 0;
+    return p_curve->sample_baked(Math::lerp(p_curve->get_min_domain(), p_curve->get_max_domain(), weight));
+}
+
+void CurveBulletPath::_locate(float p_time, int &r_index, float &r_weight) const {
+    float position = p_time*(baked_speed.size() - 1)/curve_duration;
+    r_index = MIN((int)position, baked_speed.size() - 2);
+    r_weight = position - r_index;
+}
+
+Vector2 CurveBulletPath::_get_displacement(float p_time) const {
+    int last = baked_speed.size() - 1;
+    if (p_time < curve_duration && last > 0) {
+        int index;
+        float weight;
+        _locate(MAX(p_time, 0), index, weight);
+        return baked_displacement[index].lerp(baked_displacement[index + 1], weight);
+    }
+    //past the curves the final speed and turn rate hold, which traces an arc
+    float time = p_time - MAX(curve_duration, 0);
+    float heading = baked_heading[last];
+    float turn = baked_end_turn;
+    if (Math::is_zero_approx(turn)) {
+        return baked_displacement[last] + Vector2::from_angle(heading)*baked_speed[last]*time;
+    }
+    float radius = baked_speed[last]/turn;
+    Vector2 arc = Vector2(Math::sin(heading + turn*time) - Math::sin(heading), Math::cos(heading) - Math::cos(heading + turn*time));
+    return baked_displacement[last] + arc*radius;
+}
+
+float CurveBulletPath::_get_heading(float p_time) const {
+    int last = baked_speed.size() - 1;
+    if (p_time < curve_duration && last > 0) {
+        int index;
+        float weight;
+        _locate(MAX(p_time, 0), index, weight);
+        return Math::lerp(baked_heading[index], baked_heading[index + 1], weight);
+    }
+    return baked_heading[last] + baked_end_turn*(p_time - MAX(curve_duration, 0));
+}
+
+void CurveBulletPath::set_lifetime(float p_time) {
+    lifetime = p_time;
+}
+
+float CurveBulletPath::get_lifetime() const {
+    return lifetime;
+}
+
+Vector2 CurveBulletPath::get_step(float p_time, float p_delta) const {
+    return (_get_displacement(p_time + p_delta) - _get_displacement(p_time)).rotated(init_rotation);
+}
+
+Vector2 CurveBulletPath::get_direction(float p_time) const {
+    return Vector2(1, 0).rotated(get_rotation(p_time));
+}
+
+Vector2 CurveBulletPath::get_velocity(float p_time) const {
+    return get_direction(p_time)*get_speed(p_time);
+}
+
+float CurveBulletPath::get_rotation(float p_time) const {
+    return init_rotation + _get_heading(p_time);
+}
+
+float CurveBulletPath::get_speed(float p_time) const {
+    int last = baked_speed.size() - 1;
+    if (p_time < curve_duration && last > 0) {
+        int index;
+        float weight;
+        _locate(MAX(p_time, 0), index, weight);
+        return Math::lerp(baked_speed[index], baked_speed[index + 1], weight);
+    }
+    return baked_speed[last];
+}
+
+Ref<BulletPath> CurveBulletPath::rotated(float p_rotation) const {
+    Ref<CurveBulletPath> new_path = Ref<CurveBulletPath>(memnew(CurveBulletPath(this)));
+    new_path->init_rotation = init_rotation + p_rotation;
+    new_path->_set_rotation_source(this, p_rotation);
+    return new_path;
+}
+
+Ref<BulletPath> CurveBulletPath::xformed(const Transform2D &p_transform) const {
+    Vector2 new_dir = p_transform.basis_xform(get_direction(0));
+    float delta = new_dir.length();
+
+    Ref<CurveBulletPath> new_path = Ref<CurveBulletPath>(memnew(CurveBulletPath(this)));
+    new_path->init_rotation = new_dir.angle();
+    new_path->init_speed = init_speed*delta;
+    new_path->_bake();
+    return new_path;
+}
+
+void CurveBulletPath::set_init_speed(float p_speed) {
+    init_speed = p_speed;
+    _bake();
+}
+float CurveBulletPath::get_init_speed() const {
+    return init_speed;
+}
+
+void CurveBulletPath::set_init_rotation(float p_dir) {
+    init_rotation = p_dir;
+}
+float CurveBulletPath::get_init_rotation() const {
+    return init_rotation;
+}
+
+void CurveBulletPath::set_turn_rate(float p_turn_rate) {
+    turn_rate = p_turn_rate;
+    _bake();
+}
+float CurveBulletPath::get_turn_rate() const {
+    return turn_rate;
+}
+
+void CurveBulletPath::set_speed_curve(const Ref<Curve> &p_curve) {
+    _set_curve(speed_curve, p_curve);
+}
+Ref<Curve> CurveBulletPath::get_speed_curve() const {
+    return speed_curve;
+}
+
+void CurveBulletPath::set_turn_curve(const Ref<Curve> &p_curve) {
+    _set_curve(turn_curve, p_curve);
+}
+Ref<Curve> CurveBulletPath::get_turn_curve() const {
+    return turn_curve;
+}
+
+void CurveBulletPath::set_curve_duration(float p_duration) {
+    curve_duration = MAX(p_duration, 0);
+    _bake();
+}
+float CurveBulletPath::get_curve_duration() const {
+    return curve_duration;
+}
+
+void CurveBulletPath::set_bake_resolution(int p_resolution) {
+    ERR_FAIL_COND(p_resolution < 1);
+    bake_resolution = p_resolution;
+    _bake();
+}
+int CurveBulletPath::get_bake_resolution() const {
+    return bake_resolution;
+}
+
+void CurveBulletPath::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_lifetime", "time"), &CurveBulletPath::set_lifetime);
+	ClassDB::bind_method(D_METHOD("get_lifetime"), &CurveBulletPath::get_lifetime);
+
+    ClassDB::bind_method(D_METHOD("get_step", "time", "delta"), &CurveBulletPath::get_step);
+
+	ClassDB::bind_method(D_METHOD("get_direction", "time"), &CurveBulletPath::get_direction);
+    ClassDB::bind_method(D_METHOD("get_velocity", "time"), &CurveBulletPath::get_velocity);
+    ClassDB::bind_method(D_METHOD("get_rotation", "time"), &CurveBulletPath::get_rotation);
+    ClassDB::bind_method(D_METHOD("get_speed", "time"), &CurveBulletPath::get_speed);
+
+    ClassDB::bind_method(D_METHOD("rotated", "degrees"), &CurveBulletPath::rotated);
+    ClassDB::bind_method(D_METHOD("xformed", "transform"), &CurveBulletPath::xformed);
+
+    ClassDB::bind_method(D_METHOD("set_init_speed", "speed"), &CurveBulletPath::set_init_speed);
+    ClassDB::bind_method(D_METHOD("get_init_speed"), &CurveBulletPath::get_init_speed);
+
+    ClassDB::bind_method(D_METHOD("set_init_rotation", "direction"), &CurveBulletPath::set_init_rotation);
+    ClassDB::bind_method(D_METHOD("get_init_rotation"), &CurveBulletPath::get_init_rotation);
+
+    ClassDB::bind_method(D_METHOD("set_turn_rate", "turn_rate"), &CurveBulletPath::set_turn_rate);
+    ClassDB::bind_method(D_METHOD("get_turn_rate"), &CurveBulletPath::get_turn_rate);
+
+    ClassDB::bind_method(D_METHOD("set_speed_curve", "curve"), &CurveBulletPath::set_speed_curve);
+    ClassDB::bind_method(D_METHOD("get_speed_curve"), &CurveBulletPath::get_speed_curve);
+
+    ClassDB::bind_method(D_METHOD("set_turn_curve", "curve"), &CurveBulletPath::set_turn_curve);
+    ClassDB::bind_method(D_METHOD("get_turn_curve"), &CurveBulletPath::get_turn_curve);
+
+    ClassDB::bind_method(D_METHOD("set_curve_duration", "duration"), &CurveBulletPath::set_curve_duration);
+    ClassDB::bind_method(D_METHOD("get_curve_duration"), &CurveBulletPath::get_curve_duration);
+
+    ClassDB::bind_method(D_METHOD("set_bake_resolution", "resolution"), &CurveBulletPath::set_bake_resolution);
+    ClassDB::bind_method(D_METHOD("get_bake_resolution"), &CurveBulletPath::get_bake_resolution);
+
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lifetime", PROPERTY_HINT_RANGE, "0,30,0.01,or_greater"), "set_lifetime", "get_lifetime");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "speed", PROPERTY_HINT_RANGE, "0,500,1,or_greater"), "set_init_speed", "get_init_speed");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "speed_curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve"), "set_speed_curve", "get_speed_curve");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "rotation", PROPERTY_HINT_RANGE, "-360,360,0.1,radians_as_degrees"), "set_init_rotation", "get_init_rotation");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "turn_rate", PROPERTY_HINT_RANGE, "-360,360,0.1,radians_as_degrees,or_less,or_greater"), "set_turn_rate", "get_turn_rate");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "turn_curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve"), "set_turn_curve", "get_turn_curve");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "curve_duration", PROPERTY_HINT_RANGE, "0,30,0.01,or_greater"), "set_curve_duration", "get_curve_duration");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "bake_resolution", PROPERTY_HINT_RANGE, "1,1024,1,or_greater"), "set_bake_resolution", "get_bake_resolution");
+}
+
+CurveBulletPath::CurveBulletPath() {
+    lifetime = 0;
+    init_speed = 100;
+    init_rotation = 0;
+    turn_rate = 0;
+    curve_duration = 1;
+    bake_resolution = 128;
+    speed_curve = Ref<Curve>();
+    turn_curve = Ref<Curve>();
+    tracks_curves = true;
+    _bake();
+}
+
+CurveBulletPath::CurveBulletPath(const CurveBulletPath *p_other) {
+    //copies share the curves and the baked tables; only the original rebakes when a curve is edited
+    lifetime = p_other->lifetime;
+    init_speed = p_other->init_speed;
+    init_rotation = p_other->init_rotation;
+    turn_rate = p_other->turn_rate;
+    curve_duration = p_other->curve_duration;
+    bake_resolution = p_other->bake_resolution;
+    speed_curve = p_other->speed_curve;
+    turn_curve = p_other->turn_curve;
+    baked_speed = p_other->baked_speed;
+    baked_heading = p_other->baked_heading;
+    baked_displacement = p_other->baked_displacement;
+    baked_end_turn = p_other->baked_end_turn;
+    tracks_curves = false;
+}
+
+CurveBulletPath::~CurveBulletPath() {
+    if (!tracks_curves) {
+        return;
+    }
+    if (speed_curve.is_valid()) {
+        speed_curve->disconnect_changed(callable_mp(this, &CurveBulletPath::_bake));
+    }
+    if (turn_curve.is_valid()) {
+        turn_curve->disconnect_changed(callable_mp(this, &CurveBulletPath::_bake));
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef CURVEBULLETPATH_H
+#define CURVEBULLETPATH_H
+
+#include "bullet_path.h"
+
+#include "scene/resources/curve.h"
+
+// Speed and turn rate follow Curves over curve_duration. Both are baked into
+// tables of heading and displacement when set, so every bullet on the path
+// (and on its rotated copies, which share the tables) is evaluated with a lerp.
+class CurveBulletPath : public BulletPath {
+    GDCLASS(CurveBulletPath, BulletPath);
+
+    float lifetime;
+    float init_speed;
+    float init_rotation;
+    float turn_rate;
+    float curve_duration;
+    int bake_resolution;
+    Ref<Curve> speed_curve;
+    Ref<Curve> turn_curve;
+
+    Vector<float> baked_speed;
+    Vector<float> baked_heading;
+    Vector<Vector2> baked_displacement;
+    float baked_end_turn;
+    bool tracks_curves;
+
+    void _bake();
+    void _set_curve(Ref<Curve> &r_curve, const Ref<Curve> &p_curve);
+    float _sample_curve(const Ref<Curve> &p_curve, float p_time) const;
+    void _locate(float p_time, int &r_index, float &r_weight) const;
+    Vector2 _get_displacement(float p_time) const;
+    float _get_heading(float p_time) const;
+
+protected:
+	static void _bind_methods();
+
+public:
+    void set_lifetime(float p_time);
+    virtual float get_lifetime() const override;
+
+    virtual Vector2 get_step(float p_time, float p_delta) const override;
+
+    virtual Vector2 get_direction(float p_time) const override;
+    virtual Vector2 get_velocity(float p_time) const override;
+
+    virtual float get_rotation(float p_time) const override;
+    virtual float get_speed(float p_time) const override;
+
+    virtual Ref<BulletPath> rotated(float p_rotation) const override;
+    virtual Ref<BulletPath> xformed(const Transform2D &p_transform) const override;
+
+    void set_init_speed(float p_speed);
+    float get_init_speed() const;
+
+    void set_init_rotation(float p_rotation);
+    float get_init_rotation() const;
+
+    void set_turn_rate(float p_turn_rate);
+    float get_turn_rate() const;
+
+    void set_speed_curve(const Ref<Curve> &p_curve);
+    Ref<Curve> get_speed_curve() const;
+
+    void set_turn_curve(const Ref<Curve> &p_curve);
+    Ref<Curve> get_turn_curve() const;
+
+    void set_curve_duration(float p_duration);
+    float get_curve_duration() const;
+
+    void set_bake_resolution(int p_resolution);
+    int get_bake_resolution() const;
+
+    CurveBulletPath();
+    CurveBulletPath(const CurveBulletPath *p_other);
+    ~CurveBulletPath();
+};
+
+#endif
@@ -36,6 +36,7 @@ Ref<BulletPath> ForceBulletPath::rotated(float p_rotation) const {
     if(rotate_forces_on_transform) {
         new_path->force = new_path->force.rotated(p_rotation);
     }
+    new_path->_set_rotation_source(this, p_rotation);
 
     return new_path;
 }
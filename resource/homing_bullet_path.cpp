@@ -0,0 +1,180 @@
+#include "homing_bullet_path.h"
+
+#include "scene/main/node.h"
+
+void HomingBulletPath::set_lifetime(float p_time) {
+    lifetime = p_time;
+}
+
+float HomingBulletPath::get_lifetime() const {
+    return lifetime;
+}
+
+Vector2 HomingBulletPath::get_step(float p_time, float p_delta) const {
+    return p_delta*(get_velocity(p_time + p_delta) + get_velocity(p_time))/2;
+}
+
+Vector2 HomingBulletPath::get_direction(float p_time) const {
+    return Vector2(1, 0).rotated(init_rotation);
+}
+
+Vector2 HomingBulletPath::get_velocity(float p_time) const {
+    return get_direction(p_time)*get_speed(p_time);
+}
+
+float HomingBulletPath::get_rotation(float p_time) const {
+    return init_rotation;
+}
+
+float HomingBulletPath::get_speed(float p_time) const {
+    return MIN(init_speed + acceleration*p_time, max_speed);
+}
+
+Ref<BulletPath> HomingBulletPath::rotated(float p_rotation) const {
+    Ref<HomingBulletPath> new_path = Ref<HomingBulletPath>(memnew(HomingBulletPath(this)));
+    new_path->init_rotation = init_rotation + p_rotation;
+    new_path->_set_rotation_source(this, p_rotation);
+    return new_path;
+}
+
+Ref<BulletPath> HomingBulletPath::xformed(const Transform2D &p_transform) const {
+    Vector2 new_dir = p_transform.basis_xform(get_direction(0));
+    float delta = new_dir.length();
+
+    Ref<HomingBulletPath> new_path = Ref<HomingBulletPath>(memnew(HomingBulletPath(this)));
+    new_path->init_rotation = new_dir.angle();
+    new_path->init_speed = init_speed*delta;
+    new_path->acceleration = acceleration*delta;
+    new_path->max_speed = max_speed*delta;
+    return new_path;
+}
+
+void HomingBulletPath::set_init_speed(float p_speed) {
+    init_speed = p_speed;
+}
+float HomingBulletPath::get_init_speed() const {
+    return init_speed;
+}
+
+void HomingBulletPath::set_init_rotation(float p_dir) {
+    init_rotation = p_dir;
+}
+float HomingBulletPath::get_init_rotation() const {
+    return init_rotation;
+}
+
+void HomingBulletPath::set_acceleration(float p_accel) {
+    acceleration = p_accel;
+}
+float HomingBulletPath::get_acceleration() const {
+    return acceleration;
+}
+
+void HomingBulletPath::set_max_speed(float p_max_speed) {
+    max_speed = p_max_speed;
+}
+float HomingBulletPath::get_max_speed() const {
+    return max_speed;
+}
+
+void HomingBulletPath::set_turn_rate(float p_turn_rate) {
+    turn_rate = MAX(p_turn_rate, 0);
+}
+float HomingBulletPath::get_turn_rate() const {
+    return turn_rate;
+}
+
+void HomingBulletPath::set_homing_delay(float p_delay) {
+    homing_delay = MAX(p_delay, 0);
+}
+float HomingBulletPath::get_homing_delay() const {
+    return homing_delay;
+}
+
+void HomingBulletPath::set_target_group(const StringName &p_group) {
+    target_group = p_group;
+}
+StringName HomingBulletPath::get_target_group() const {
+    return target_group;
+}
+
+void HomingBulletPath::set_target_node(Node *p_node) {
+    target_node = p_node ? p_node->get_instance_id() : ObjectID();
+}
+Node *HomingBulletPath::get_target_node() const {
+    return Object::cast_to<Node>(ObjectDB::get_instance(target_node));
+}
+
+void HomingBulletPath::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_lifetime", "time"), &HomingBulletPath::set_lifetime);
+	ClassDB::bind_method(D_METHOD("get_lifetime"), &HomingBulletPath::get_lifetime);
+
+    ClassDB::bind_method(D_METHOD("get_step", "time", "delta"), &HomingBulletPath::get_step);
+
+	ClassDB::bind_method(D_METHOD("get_direction", "time"), &HomingBulletPath::get_direction);
+    ClassDB::bind_method(D_METHOD("get_velocity", "time"), &HomingBulletPath::get_velocity);
+    ClassDB::bind_method(D_METHOD("get_rotation", "time"), &HomingBulletPath::get_rotation);
+    ClassDB::bind_method(D_METHOD("get_speed", "time"), &HomingBulletPath::get_speed);
+
+    ClassDB::bind_method(D_METHOD("rotated", "degrees"), &HomingBulletPath::rotated);
+    ClassDB::bind_method(D_METHOD("xformed", "transform"), &HomingBulletPath::xformed);
+
+    ClassDB::bind_method(D_METHOD("set_init_speed", "speed"), &HomingBulletPath::set_init_speed);
+    ClassDB::bind_method(D_METHOD("get_init_speed"), &HomingBulletPath::get_init_speed);
+
+    ClassDB::bind_method(D_METHOD("set_init_rotation", "direction"), &HomingBulletPath::set_init_rotation);
+    ClassDB::bind_method(D_METHOD("get_init_rotation"), &HomingBulletPath::get_init_rotation);
+
+    ClassDB::bind_method(D_METHOD("set_acceleration", "acceleration"), &HomingBulletPath::set_acceleration);
+    ClassDB::bind_method(D_METHOD("get_acceleration"), &HomingBulletPath::get_acceleration);
+
+    ClassDB::bind_method(D_METHOD("set_max_speed", "speed_clamp"), &HomingBulletPath::set_max_speed);
+    ClassDB::bind_method(D_METHOD("get_max_speed"), &HomingBulletPath::get_max_speed);
+
+    ClassDB::bind_method(D_METHOD("set_turn_rate", "turn_rate"), &HomingBulletPath::set_turn_rate);
+    ClassDB::bind_method(D_METHOD("get_turn_rate"), &HomingBulletPath::get_turn_rate);
+
+    ClassDB::bind_method(D_METHOD("set_homing_delay", "delay"), &HomingBulletPath::set_homing_delay);
+    ClassDB::bind_method(D_METHOD("get_homing_delay"), &HomingBulletPath::get_homing_delay);
+
+    ClassDB::bind_method(D_METHOD("set_target_group", "group"), &HomingBulletPath::set_target_group);
+    ClassDB::bind_method(D_METHOD("get_target_group"), &HomingBulletPath::get_target_group);
+
+    ClassDB::bind_method(D_METHOD("set_target_node", "node"), &HomingBulletPath::set_target_node);
+    ClassDB::bind_method(D_METHOD("get_target_node"), &HomingBulletPath::get_target_node);
+
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lifetime", PROPERTY_HINT_RANGE, "0,30,0.01,or_greater"), "set_lifetime", "get_lifetime");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "speed", PROPERTY_HINT_RANGE, "0,500,1,or_greater"), "set_init_speed", "get_init_speed");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "acceleration", PROPERTY_HINT_RANGE, "-200,200,0.1,or_less,or_greater"), "set_acceleration", "get_acceleration");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "max_speed", PROPERTY_HINT_RANGE, "0,500,0.1,or_greater"), "set_max_speed", "get_max_speed");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "rotation", PROPERTY_HINT_RANGE, "-360,360,0.1,radians_as_degrees"), "set_init_rotation", "get_init_rotation");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "turn_rate", PROPERTY_HINT_RANGE, "0,720,0.1,radians_as_degrees,or_greater"), "set_turn_rate", "get_turn_rate");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "homing_delay", PROPERTY_HINT_RANGE, "0,10,0.01,or_greater"), "set_homing_delay", "get_homing_delay");
+    ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "target_group"), "set_target_group", "get_target_group");
+}
+
+HomingBulletPath::HomingBulletPath() {
+    lifetime = 0;
+    init_speed = 100;
+    init_rotation = 0;
+    acceleration = 0;
+    max_speed = 500;
+    turn_rate = Math::PI;
+    homing_delay = 0;
+    target_group = StringName();
+    target_node = ObjectID();
+}
+
+HomingBulletPath::HomingBulletPath(const HomingBulletPath *p_other) {
+    lifetime = p_other->lifetime;
+    init_speed = p_other->init_speed;
+    init_rotation = p_other->init_rotation;
+    acceleration = p_other->acceleration;
+    max_speed = p_other->max_speed;
+    turn_rate = p_other->turn_rate;
+    homing_delay = p_other->homing_delay;
+    target_group = p_other->target_group;
+    target_node = p_other->target_node;
+}
+
+HomingBulletPath::~HomingBulletPath() {}
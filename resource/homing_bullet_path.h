@@ -0,0 +1,76 @@
+#ifndef HOMINGBULLETPATH_H
+#define HOMINGBULLETPATH_H
+
+#include "bullet_path.h"
+
+#include "core/object/object_id.h"
+
+class Node;
+
+// Steers toward a target instead of following a fixed curve. The time
+// functions describe the unsteered flight; the server keeps each bullet's
+// actual velocity and turns it every tick.
+class HomingBulletPath : public BulletPath {
+    GDCLASS(HomingBulletPath, BulletPath);
+
+    float lifetime;
+    float init_speed;
+    float init_rotation;
+    float acceleration;
+    float max_speed;
+    float turn_rate;
+    float homing_delay;
+    StringName target_group;
+    ObjectID target_node;
+
+protected:
+	static void _bind_methods();
+
+public:
+    virtual bool is_homing() const override { return true; }
+
+    void set_lifetime(float p_time);
+    virtual float get_lifetime() const override;
+
+    virtual Vector2 get_step(float p_time, float p_delta) const override;
+
+    virtual Vector2 get_direction(float p_time) const override;
+    virtual Vector2 get_velocity(float p_time) const override;
+
+    virtual float get_rotation(float p_time) const override;
+    virtual float get_speed(float p_time) const override;
+
+    virtual Ref<BulletPath> rotated(float p_rotation) const override;
+    virtual Ref<BulletPath> xformed(const Transform2D &p_transform) const override;
+
+    void set_init_speed(float p_speed);
+    float get_init_speed() const;
+
+    void set_init_rotation(float p_rotation);
+    float get_init_rotation() const;
+
+    void set_acceleration(float p_accel);
+    float get_acceleration() const;
+
+    void set_max_speed(float p_max_speed);
+    float get_max_speed() const;
+
+    void set_turn_rate(float p_turn_rate);
+    float get_turn_rate() const;
+
+    void set_homing_delay(float p_delay);
+    float get_homing_delay() const;
+
+    void set_target_group(const StringName &p_group);
+    StringName get_target_group() const;
+
+    void set_target_node(Node *p_node);
+    Node *get_target_node() const;
+    ObjectID get_target_node_id() const { return target_node; }
+
+    HomingBulletPath();
+    HomingBulletPath(const HomingBulletPath *p_other);
+    ~HomingBulletPath();
+};
+
+#endif
@@ -0,0 +1,237 @@
+#include "sequence_bullet_path.h"
+
+void SequenceBulletPath::_rebuild() {
+    segment_paths.clear();
+    segment_starts.clear();
+    segment_rotations.clear();
+
+    float start = 0;
+    float turn = 0;
+    for (int i = 0; i < paths.size(); i++) {
+        Ref<BulletPath> path = paths[i];
+        if (path.is_null()) {
+            continue;
+        }
+        //sequences are kept acyclic, so stepping one always ends
+        Ref<SequenceBulletPath> sequence = path;
+        HashSet<const SequenceBulletPath *> visited;
+        ERR_CONTINUE_MSG(sequence.is_valid() && sequence->_reaches(this, visited), "A SequenceBulletPath can't contain itself, directly or through the sequences it contains.");
+        //the server only steers bullets whose own path is homing
+        ERR_CONTINUE_MSG(path->is_homing(), "A SequenceBulletPath can't contain homing paths.");
+        if (align_segments && !segment_paths.is_empty()) {
+            //each segment sets off in the direction the previous one ended in
+            int last = segment_paths.size() - 1;
+            turn = segment_paths[last]->get_rotation(start - segment_starts[last]) + segment_rotations[last] - path->get_rotation(0);
+        }
+        segment_paths.push_back(path);
+        segment_starts.push_back(start);
+        segment_rotations.push_back(turn);
+        start += i < durations.size() ? MAX(durations[i], 0) : 0;
+    }
+}
+
+bool SequenceBulletPath::_reaches(const SequenceBulletPath *p_target, HashSet<const SequenceBulletPath *> &r_visited) const {
+    if (this == p_target) {
+        return true;
+    }
+    if (r_visited.has(this)) {
+        return false;
+    }
+    r_visited.insert(this);
+    for (int i = 0; i < paths.size(); i++) {
+        Ref<SequenceBulletPath> sequence = paths[i];
+        if (sequence.is_valid() && sequence->_reaches(p_target, r_visited)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int SequenceBulletPath::_find_segment(float p_time) const {
+    //the last segment starting at or before p_time
+    int low = 0;
+    int high = segment_starts.size() - 1;
+    while (low < high) {
+        int mid = (low + high + 1)/2;
+        if (segment_starts[mid] <= p_time) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+void SequenceBulletPath::set_lifetime(float p_time) {
+    lifetime = p_time;
+}
+
+float SequenceBulletPath::get_lifetime() const {
+    return lifetime;
+}
+
+Vector2 SequenceBulletPath::get_step(float p_time, float p_delta) const {
+    if (segment_paths.is_empty()) {
+        return Vector2();
+    }
+    //a step that crosses into the next segment is split at the boundary
+    Vector2 step;
+    float time = p_time;
+    float end = p_time + p_delta;
+    int segment = _find_segment(time);
+    while (true) {
+        float segment_end = segment + 1 < segment_starts.size() ? segment_starts[segment + 1] : end;
+        float part = MIN(end, segment_end) - time;
+        if (part > 0) {
+            step += segment_paths[segment]->get_step(time - segment_starts[segment], part).rotated(segment_rotations[segment]);
+        }
+        if (end <= segment_end) {
+            break;
+        }
+        time = segment_end;
+        segment++;
+    }
+    return step.rotated(rotation);
+}
+
+Vector2 SequenceBulletPath::get_direction(float p_time) const {
+    return Vector2(1, 0).rotated(get_rotation(p_time));
+}
+
+Vector2 SequenceBulletPath::get_velocity(float p_time) const {
+    if (segment_paths.is_empty()) {
+        return Vector2();
+    }
+    int segment = _find_segment(p_time);
+    return segment_paths[segment]->get_velocity(p_time - segment_starts[segment]).rotated(segment_rotations[segment] + rotation);
+}
+
+float SequenceBulletPath::get_rotation(float p_time) const {
+    if (segment_paths.is_empty()) {
+        return rotation;
+    }
+    int segment = _find_segment(p_time);
+    return segment_paths[segment]->get_rotation(p_time - segment_starts[segment]) + segment_rotations[segment] + rotation;
+}
+
+float SequenceBulletPath::get_speed(float p_time) const {
+    if (segment_paths.is_empty()) {
+        return 0;
+    }
+    int segment = _find_segment(p_time);
+    return segment_paths[segment]->get_speed(p_time - segment_starts[segment]);
+}
+
+Ref<BulletPath> SequenceBulletPath::rotated(float p_rotation) const {
+    Ref<SequenceBulletPath> new_path = Ref<SequenceBulletPath>(memnew(SequenceBulletPath(this)));
+    new_path->rotation = rotation + p_rotation;
+    new_path->_set_rotation_source(this, p_rotation);
+    return new_path;
+}
+
+Ref<BulletPath> SequenceBulletPath::xformed(const Transform2D &p_transform) const {
+    Ref<SequenceBulletPath> new_path = Ref<SequenceBulletPath>(memnew(SequenceBulletPath(this)));
+    Transform2D xform = p_transform;
+    xform.set_origin(Vector2());
+    Array new_paths;
+    for (int i = 0; i < paths.size(); i++) {
+        Ref<BulletPath> path = paths[i];
+        //segments are xformed in the sequence's frame, which the copy keeps
+        new_paths.push_back(path.is_valid() ? path->xformed(Transform2D(-rotation, Vector2()) * xform * Transform2D(rotation, Vector2())) : path);
+    }
+    new_path->paths = new_paths;
+    new_path->_rebuild();
+    return new_path;
+}
+
+void SequenceBulletPath::set_paths(const Array &p_paths) {
+    paths = p_paths;
+    _rebuild();
+}
+Array SequenceBulletPath::get_paths() const {
+    return paths;
+}
+
+void SequenceBulletPath::set_durations(const PackedFloat32Array &p_durations) {
+    durations = p_durations;
+    _rebuild();
+}
+PackedFloat32Array SequenceBulletPath::get_durations() const {
+    return durations;
+}
+
+void SequenceBulletPath::set_align_segments(bool p_align) {
+    align_segments = p_align;
+    _rebuild();
+}
+bool SequenceBulletPath::get_align_segments() const {
+    return align_segments;
+}
+
+int SequenceBulletPath::get_segment_count() const {
+    return segment_paths.size();
+}
+
+float SequenceBulletPath::get_segment_start(int p_segment) const {
+    ERR_FAIL_INDEX_V(p_segment, segment_starts.size(), 0);
+    return segment_starts[p_segment];
+}
+
+int SequenceBulletPath::get_segment_at(float p_time) const {
+    return segment_paths.is_empty() ? -1 : _find_segment(p_time);
+}
+
+void SequenceBulletPath::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_lifetime", "time"), &SequenceBulletPath::set_lifetime);
+	ClassDB::bind_method(D_METHOD("get_lifetime"), &SequenceBulletPath::get_lifetime);
+
+    ClassDB::bind_method(D_METHOD("get_step", "time", "delta"), &SequenceBulletPath::get_step);
+
+	ClassDB::bind_method(D_METHOD("get_direction", "time"), &SequenceBulletPath::get_direction);
+    ClassDB::bind_method(D_METHOD("get_velocity", "time"), &SequenceBulletPath::get_velocity);
+    ClassDB::bind_method(D_METHOD("get_rotation", "time"), &SequenceBulletPath::get_rotation);
+    ClassDB::bind_method(D_METHOD("get_speed", "time"), &SequenceBulletPath::get_speed);
+
+    ClassDB::bind_method(D_METHOD("rotated", "degrees"), &SequenceBulletPath::rotated);
+    ClassDB::bind_method(D_METHOD("xformed", "transform"), &SequenceBulletPath::xformed);
+
+    ClassDB::bind_method(D_METHOD("set_paths", "paths"), &SequenceBulletPath::set_paths);
+    ClassDB::bind_method(D_METHOD("get_paths"), &SequenceBulletPath::get_paths);
+
+    ClassDB::bind_method(D_METHOD("set_durations", "durations"), &SequenceBulletPath::set_durations);
+    ClassDB::bind_method(D_METHOD("get_durations"), &SequenceBulletPath::get_durations);
+
+    ClassDB::bind_method(D_METHOD("set_align_segments", "align"), &SequenceBulletPath::set_align_segments);
+    ClassDB::bind_method(D_METHOD("get_align_segments"), &SequenceBulletPath::get_align_segments);
+
+    ClassDB::bind_method(D_METHOD("get_segment_count"), &SequenceBulletPath::get_segment_count);
+    ClassDB::bind_method(D_METHOD("get_segment_start", "segment"), &SequenceBulletPath::get_segment_start);
+    ClassDB::bind_method(D_METHOD("get_segment_at", "time"), &SequenceBulletPath::get_segment_at);
+
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lifetime", PROPERTY_HINT_RANGE, "0,30,0.01,or_greater"), "set_lifetime", "get_lifetime");
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "paths", PROPERTY_HINT_ARRAY_TYPE, MAKE_RESOURCE_TYPE_HINT("BulletPath")), "set_paths", "get_paths");
+    ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "durations"), "set_durations", "get_durations");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "align_segments"), "set_align_segments", "get_align_segments");
+}
+
+SequenceBulletPath::SequenceBulletPath() {
+    lifetime = 0;
+    paths = Array();
+    durations = PackedFloat32Array();
+    align_segments = true;
+    rotation = 0;
+}
+
+SequenceBulletPath::SequenceBulletPath(const SequenceBulletPath *p_other) {
+    //copies share the segment tables until one of them is changed
+    lifetime = p_other->lifetime;
+    paths = p_other->paths;
+    durations = p_other->durations;
+    align_segments = p_other->align_segments;
+    rotation = p_other->rotation;
+    segment_paths = p_other->segment_paths;
+    segment_starts = p_other->segment_starts;
+    segment_rotations = p_other->segment_rotations;
+}
+
+SequenceBulletPath::~SequenceBulletPath() {}
@@ -0,0 +1,65 @@
+#ifndef SEQUENCEBULLETPATH_H
+#define SEQUENCEBULLETPATH_H
+
+#include "bullet_path.h"
+
+#include "core/templates/hash_set.h"
+#include "core/variant/array.h"
+
+// Runs other paths one after another, each for its duration. Segment start
+// times and turns are worked out when the segments change, so stepping a
+// bullet is a binary search rather than a path swap on every transition.
+class SequenceBulletPath : public BulletPath {
+    GDCLASS(SequenceBulletPath, BulletPath);
+
+    float lifetime;
+    Array paths;
+    PackedFloat32Array durations;
+    bool align_segments;
+    float rotation;
+
+    Vector<Ref<BulletPath>> segment_paths;
+    Vector<float> segment_starts;
+    Vector<float> segment_rotations;
+
+    void _rebuild();
+    bool _reaches(const SequenceBulletPath *p_target, HashSet<const SequenceBulletPath *> &r_visited) const;
+    int _find_segment(float p_time) const;
+
+protected:
+	static void _bind_methods();
+
+public:
+    void set_lifetime(float p_time);
+    virtual float get_lifetime() const override;
+
+    virtual Vector2 get_step(float p_time, float p_delta) const override;
+
+    virtual Vector2 get_direction(float p_time) const override;
+    virtual Vector2 get_velocity(float p_time) const override;
+
+    virtual float get_rotation(float p_time) const override;
+    virtual float get_speed(float p_time) const override;
+
+    virtual Ref<BulletPath> rotated(float p_rotation) const override;
+    virtual Ref<BulletPath> xformed(const Transform2D &p_transform) const override;
+
+    void set_paths(const Array &p_paths);
+    Array get_paths() const;
+
+    void set_durations(const PackedFloat32Array &p_durations);
+    PackedFloat32Array get_durations() const;
+
+    void set_align_segments(bool p_align);
+    bool get_align_segments() const;
+
+    int get_segment_count() const;
+    float get_segment_start(int p_segment) const;
+    int get_segment_at(float p_time) const;
+
+    SequenceBulletPath();
+    SequenceBulletPath(const SequenceBulletPath *p_other);
+    ~SequenceBulletPath();
+};
+
+#endif
@@ -29,7 +29,7 @@ float SimpleBulletPath::get_speed(float p_time) const {
 }
 
 Ref<BulletPath> SimpleBulletPath::rotated(float p_rotation) const {
-    return Ref<SimpleBulletPath>(memnew(SimpleBulletPath(
+    Ref<SimpleBulletPath> new_path = Ref<SimpleBulletPath>(memnew(SimpleBulletPath(
         init_speed, 
         init_rotation + p_rotation,
         lifetime,
@@ -38,6 +38,8 @@ Ref<BulletPath> SimpleBulletPath::rotated(float p_rotation) const {
         min_speed,
         curve_rate
     )));
+    new_path->_set_rotation_source(this, p_rotation);
+    return new_path;
 }
 
 Ref<BulletPath> SimpleBulletPath::xformed(const Transform2D &p_transform) const {